@@ -38,7 +38,7 @@ public partial class MainWindow : Window
                 Title = "选择mem文件",
                 FileTypeFilter = new[] { new FilePickerFileType("Files")
             {
-                Patterns = new [] { "*.mem" },
+                Patterns = new [] { "*.mem", "*.vgo" },
             } },
             };
             var result = await this.StorageProvider.OpenFilePickerAsync(option);
@@ -56,6 +56,10 @@ public partial class MainWindow : Window
                 Viewer.Geometry.Adapter.GetGeometryByPath(filename, out IContract.AsmGeometry geometry);
                 this.GL.GLControl.UpdateGeometry(ref geometry);
             }
+            else if (filename.EndsWith(".vgo"))
+            {
+                this.GL.GLControl.LoadModel(filename);
+            }
             GC.Collect();
             stop.Stop();
             Console.WriteLine(stop.ElapsedMilliseconds);
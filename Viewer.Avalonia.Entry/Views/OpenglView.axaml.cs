@@ -60,7 +60,8 @@ public partial class OpenglView : UserControl
                 // 记录当前坐标
                 var p = args.GetPosition(this);
                 args.Handled = true;
-                Vgo.gl_control_mouse_down((int)KeyCode.Left, (int)p.X, (int)p.Y);
+                // 与松开时一致使用像素坐标,框选需要两个角点在同一坐标系下
+                Vgo.gl_control_mouse_down((int)KeyCode.Left, (int)(p.X * scale), (int)(p.Y * scale));
             }
         };
         this.PointerReleased += (sender, args) =>
@@ -111,6 +112,9 @@ public class OpenGlPageControl : OpenGlControlBase
     AsmGeometry? lastGeometry;
     bool updateAsm = false;
 
+    string modelPath;
+    bool updateModel = false;
+
     uint width = 0;
 
     uint height = 0;
@@ -180,12 +184,25 @@ public class OpenGlPageControl : OpenGlControlBase
                 lastGeometry = null;
             }
         }
+        if(updateModel)
+        {
+            updateModel = false;
+            if (Vgo.gl_control_load_model(modelPath) != 0)
+            {
+                Console.WriteLine($"load model failed: {modelPath}");
+            }
+        }
         if(updateSize)
         {
             updateSize = false;
             Vgo.gl_control_resize((int)width, (int)height);
         }
         Vgo.gl_control_render();
+        //v2模型的part在渲染时逐步加载,加载完之前不能停止刷新
+        if (Vgo.gl_control_pending_parts() > 0)
+        {
+            ResetWatch();
+        }
         this.RequestNextFrameRendering();
     }
 
@@ -199,6 +216,13 @@ public class OpenGlPageControl : OpenGlControlBase
 
 
 
+    public void LoadModel(string path)
+    {
+        this.modelPath = path;
+        this.updateModel = true;
+        ResetWatch();
+    }
+
     protected override void OnSizeChanged(SizeChangedEventArgs e)
     {
         base.OnSizeChanged(e);
@@ -0,0 +1,43 @@
+using System;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Viewer.IContract
+{
+    [Flags]
+    public enum ComponentStateFlags : uint
+    {
+        None = 0b00,
+        Visible = 0b01,
+        Highlight = 0b10,
+    }
+
+    /// <summary>
+    /// 组件的显示状态,与vgo中的ComponentState_t布局一致
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ComponentState
+    {
+        public Vector4 Color;
+
+        public ComponentStateFlags Flags;
+
+        /// <summary>
+        /// 高亮的面id区间[FaceBegin,FaceEnd)
+        /// </summary>
+        public int FaceBegin;
+
+        public int FaceEnd;
+
+        private int reserved;
+
+        public static ComponentState GetDefault()
+        {
+            return new ComponentState
+            {
+                Color = new Vector4(0.5882353f, 0.5882353f, 0.5882353f, 1.0f),
+                Flags = ComponentStateFlags.Visible,
+            };
+        }
+    }
+}
@@ -0,0 +1,19 @@
+using System.Runtime.InteropServices;
+
+namespace Viewer.IContract
+{
+    /// <summary>
+    /// 最近一帧的meshlet剔除统计,单位是三角形,与vgo中的CullStats_t布局一致
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CullStats
+    {
+        public long Triangles;
+
+        public long BackfaceCulled;
+
+        public long FrustumCulled;
+
+        public double CulledFraction => Triangles == 0 ? 0.0 : (double)(BackfaceCulled + FrustumCulled) / Triangles;
+    }
+}
@@ -0,0 +1,17 @@
+using System.Runtime.InteropServices;
+
+namespace Viewer.IContract
+{
+    /// <summary>
+    /// 原型面/边在一个part中对应的图元id区间[Begin,End),与vgo中的ProtoRef_t布局一致
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ProtoRef
+    {
+        public int PartIndex;
+
+        public int Begin;
+
+        public int End;
+    }
+}
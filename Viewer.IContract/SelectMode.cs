@@ -0,0 +1,18 @@
+namespace Viewer.IContract
+{
+    /// <summary>
+    /// 框选模式,与vgo中的SelectMode_*一致
+    /// </summary>
+    public enum SelectMode : int
+    {
+        /// <summary>
+        /// 组件完全在矩形内才选中
+        /// </summary>
+        Inside = 0,
+
+        /// <summary>
+        /// 组件与矩形相交即选中
+        /// </summary>
+        Crossing = 1,
+    }
+}
@@ -21,6 +21,45 @@ public unsafe sealed class Vgo
     [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_update_geometry")]
     public static extern void gl_control_update_geometry(ref AsmGeometry asmGeometry);
 
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,CharSet =CharSet.Ansi,EntryPoint = "gl_control_load_model")]
+    public static extern int gl_control_load_model(string path);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,CharSet =CharSet.Ansi,EntryPoint = "gl_control_snapshot")]
+    public static extern int gl_control_snapshot(int width, int height, string path);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_set_component_states")]
+    public static extern void gl_control_set_component_states(int* ids, ComponentState* states, int n);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_pending_parts")]
+    public static extern int gl_control_pending_parts();
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_get_cull_stats")]
+    public static extern void gl_control_get_cull_stats(out CullStats stats);
+
+    /// <summary>
+    /// 返回的指针指向vgo内部数组,在下一次更新几何之前有效
+    /// </summary>
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_find_proto_face")]
+    public static extern ProtoRef* gl_control_find_proto_face(int protoId, out int count);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_find_proto_edge")]
+    public static extern ProtoRef* gl_control_find_proto_edge(int protoId, out int count);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_get_part_components")]
+    public static extern int* gl_control_get_part_components(int partIndex, out int count);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_highlight_proto_face")]
+    public static extern int gl_control_highlight_proto_face(int protoId);
+
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_select_rect")]
+    public static extern int gl_control_select_rect(int x0, int y0, int x1, int y1, SelectMode mode);
+
+    /// <summary>
+    /// 返回的指针指向vgo内部数组,在下一次框选或更新几何之前有效
+    /// </summary>
+    [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_get_selection")]
+    public static extern int* gl_control_get_selection(out int count);
+
     [DllImport("vgo.dll", CallingConvention = CallingConvention.Cdecl,EntryPoint = "gl_control_mouse_down")]
     public static extern void gl_control_mouse_down(int keycode, int x, int y);
 
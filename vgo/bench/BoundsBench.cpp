@@ -0,0 +1,82 @@
+#include "Bounds.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// 1M个随机旋转的组件,对比串行8角点,串行CreateAsmWorldRH和并行BoundsCache
+// 用法: vgo_bench_bounds [组件数量]
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+vgo::Aabb CornerBounds(const vgo::AsmGeometry &asmGeometry)
+{
+    vgo::Aabb result;
+    for (const auto &comp : asmGeometry.Components)
+    {
+        const auto &part = asmGeometry.Parts[comp.PartIndex];
+        for (int32_t i = 0; i < 8; i++)
+        {
+            glm::vec3 corner(part.Box[i & 1].x, part.Box[(i >> 1) & 1].y, part.Box[(i >> 2) & 1].z);
+            glm::vec3 p = comp.CompMatrix * glm::vec4(corner, 1.0f);
+            result.Min = glm::min(result.Min, p);
+            result.Max = glm::max(result.Max, p);
+        }
+    }
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int32_t compCount = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector<vgo::PartGeometry> parts(1);
+    parts[0].Box[0] = glm::vec3(-1.0f, -2.0f, -0.5f);
+    parts[0].Box[1] = glm::vec3(3.0f, 2.0f, 0.5f);
+    std::vector<vgo::CompGeometry> comps(compCount);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    for (auto &comp : comps)
+    {
+        comp.PartIndex = 0;
+        glm::mat4 trans = glm::translate(vgo::Mat4Identity, glm::vec3(position(random), position(random), position(random)));
+        trans = glm::rotate(trans, angle(random), glm::normalize(glm::vec3(position(random), position(random), 1.0f)));
+        comp.CompMatrix = trans;
+    }
+    vgo::AsmGeometry asmGeometry;
+    asmGeometry.Parts = vgo::UnSafeArray<vgo::PartGeometry>(parts.data(), 1);
+    asmGeometry.Components = vgo::UnSafeArray<vgo::CompGeometry>(comps.data(), compCount);
+
+    auto start = Clock::now();
+    auto corners = CornerBounds(asmGeometry);
+    auto cornerMs = ElapsedMs(start);
+
+    start = Clock::now();
+    glm::mat4 world;
+    asmGeometry.CreateAsmWorldRH(1, 1, world);
+    auto serialMs = ElapsedMs(start);
+
+    // 第一次Update包含分配缓存的时间,单独统计
+    vgo::BoundsCache cache;
+    start = Clock::now();
+    cache.Update(asmGeometry);
+    auto firstMs = ElapsedMs(start);
+    start = Clock::now();
+    cache.Update(asmGeometry);
+    auto parallelMs = ElapsedMs(start);
+
+    auto error = glm::max(glm::abs(cache.GetBounds().Min - corners.Min), glm::abs(cache.GetBounds().Max - corners.Max));
+    std::cout << compCount << " components\n";
+    std::cout << "  serial 8 corners      " << cornerMs << " ms\n";
+    std::cout << "  serial CreateAsmWorld " << serialMs << " ms\n";
+    std::cout << "  parallel BoundsCache  " << parallelMs << " ms (first update " << firstMs << " ms)\n";
+    std::cout << "  max difference to 8 corners " << glm::max(error.x, glm::max(error.y, error.z)) << std::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "ModelFile.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+// 对比.mem和v2容器的首帧时间:
+// .mem必须读完所有part才能计算包围盒,v2只需要目录,组件表和第一个组件的part
+// 只有part很多的装配体才能从按需加载中受益;prt1这样的单part模型第一个part就是全部数据,
+// v2还要多做一次哈希校验,压缩后还要整块解压,首帧比.mem慢,压缩只换来更小的文件
+// 用法: vgo_bench_first_frame [TestModel/prt1.mem]
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double MemFirstFrame(const std::filesystem::path &path)
+{
+    auto start = Clock::now();
+    vgo::MemModel mem(path);
+    glm::mat4 world;
+    mem.GetGeometry().CreateAsmWorldRH(1, 1, world);
+    return ElapsedMs(start);
+}
+
+double ModelFirstFrame(const std::filesystem::path &path, double &fullMs)
+{
+    auto start = Clock::now();
+    vgo::ModelFile model(path);
+    glm::mat4 world;
+    model.GetGeometry().CreateAsmWorldRH(1, 1, world);
+    if (model.GetGeometry().Components.size() > 0)
+    {
+        model.LoadPart(model.GetGeometry().Components[0].PartIndex);
+    }
+    auto firstMs = ElapsedMs(start);
+    for (int32_t i = 0; i < model.GetPartCount(); i++)
+    {
+        model.LoadPart(i);
+    }
+    fullMs = ElapsedMs(start);
+    return firstMs;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::filesystem::path memPath = argc > 1 ? argv[1] : "TestModel/prt1.mem";
+    auto rawPath = std::filesystem::temp_directory_path() / "vgo_bench_raw.vgo";
+    auto lzPath = std::filesystem::temp_directory_path() / "vgo_bench_lz.vgo";
+    constexpr int32_t Runs = 10;
+    try
+    {
+        {
+            vgo::MemModel mem(memPath);
+            vgo::WriteModelFile(mem.GetGeometry(), rawPath, false);
+            vgo::WriteModelFile(mem.GetGeometry(), lzPath, true);
+        }
+        double memMs = 0, rawMs = 0, rawFullMs = 0, lzMs = 0, lzFullMs = 0;
+        for (int32_t i = 0; i < Runs; i++)
+        {
+            double fullMs;
+            memMs += MemFirstFrame(memPath);
+            rawMs += ModelFirstFrame(rawPath, fullMs);
+            rawFullMs += fullMs;
+            lzMs += ModelFirstFrame(lzPath, fullMs);
+            lzFullMs += fullMs;
+        }
+        std::cout << memPath.string() << " (" << Runs << " runs, average)\n";
+        std::cout << "  mem            first frame " << memMs / Runs << " ms, "
+                  << std::filesystem::file_size(memPath) << " bytes\n";
+        std::cout << "  vgo            first frame " << rawMs / Runs << " ms, all parts " << rawFullMs / Runs
+                  << " ms, " << std::filesystem::file_size(rawPath) << " bytes\n";
+        std::cout << "  vgo compressed first frame " << lzMs / Runs << " ms, all parts " << lzFullMs / Runs
+                  << " ms, " << std::filesystem::file_size(lzPath) << " bytes" << std::endl;
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(lzPath);
+    return 0;
+}
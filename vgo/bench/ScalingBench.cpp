@@ -0,0 +1,261 @@
+#include "Bounds.h"
+#include "DrawList.h"
+#include "Meshlet.h"
+#include "ProtoIndex.h"
+#include "Selection.h"
+#include "SyntheticAssembly.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// vgo CPU端各阶段随组件数量的耗时,输出JSON,用于发现算法复杂度上的退化
+// 用法: vgo_bench_scaling [--comps 10000,100000,1000000] [--tris 256] [--instancing 0.99]
+//                         [--distribution uniform|grid|clustered] [--repeat 3] [--seed 1] [--out result.json]
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::vector<int32_t> CompCounts{10000, 100000, 1000000};
+    vgo::SyntheticParams Params;
+    int32_t Repeat = 3;
+    std::string Out;
+};
+
+struct Stage
+{
+    std::string Name;
+    std::function<void()> Run;
+    // 可选,返回附加的JSON字段
+    std::function<std::string()> Report = {};
+};
+
+std::vector<int32_t> ParseList(const std::string &text)
+{
+    std::vector<int32_t> result;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        result.push_back(std::stoi(item));
+    }
+    return result;
+}
+
+Options ParseOptions(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--comps")
+        {
+            options.CompCounts = ParseList(value);
+        }
+        else if (key == "--tris")
+        {
+            options.Params.TrianglesPerPart = std::stoi(value);
+        }
+        else if (key == "--instancing")
+        {
+            options.Params.InstancingRatio = std::stof(value);
+        }
+        else if (key == "--distribution")
+        {
+            options.Params.Distribution = vgo::ParseDistribution(value);
+        }
+        else if (key == "--repeat")
+        {
+            options.Repeat = std::max(1, std::stoi(value));
+        }
+        else if (key == "--seed")
+        {
+            options.Params.Seed = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (key == "--out")
+        {
+            options.Out = value;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option: " + key);
+        }
+    }
+    return options;
+}
+
+// 与GlRender相同的相机: 模型适配到[-1,1],从z=-20看向原点,orthoScale越小视野越小
+vgo::CullCamera MakeCamera(const glm::mat4 &world, float orthoScale)
+{
+    return vgo::CullCamera{glm::lookAt(glm::vec3(0.0f, 0.0f, -20.0f), vgo::Vec3Zero, vgo::Vec3Unity) * world,
+                           glm::ortho(-orthoScale, orthoScale, -orthoScale, orthoScale, 0.1f, 100.0f),
+                           glm::vec2(0.0f)};
+}
+
+std::string CullReport(const vgo::CullStats &stats, size_t ranges)
+{
+    std::ostringstream out;
+    out << ", \"triangles\": " << stats.Triangles << ", \"backface_culled\": " << stats.BackfaceCulled
+        << ", \"frustum_culled\": " << stats.FrustumCulled << ", \"culled_fraction\": " << stats.GetCulledFraction()
+        << ", \"ranges\": " << ranges;
+    return out.str();
+}
+
+// 多次运行取中位数
+double MedianMs(const std::function<void()> &run, int32_t repeat)
+{
+    std::vector<double> times;
+    for (int32_t i = 0; i < repeat; i++)
+    {
+        auto start = Clock::now();
+        run();
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        auto options = ParseOptions(argc, argv);
+        std::ostringstream json;
+        json << "{\n  \"benchmark\": \"vgo_scaling\",\n";
+        json << "  \"params\": {\"tris_per_part\": " << options.Params.TrianglesPerPart
+             << ", \"instancing\": " << options.Params.InstancingRatio << ", \"distribution\": \""
+             << vgo::DistributionName(options.Params.Distribution) << "\", \"seed\": " << options.Params.Seed
+             << ", \"repeat\": " << options.Repeat << "},\n";
+        json << "  \"results\": [";
+        for (size_t n = 0; n < options.CompCounts.size(); n++)
+        {
+            auto params = options.Params;
+            params.CompCount = options.CompCounts[n];
+            auto generateStart = Clock::now();
+            vgo::SyntheticAssembly assembly(params);
+            auto generateMs = std::chrono::duration<double, std::milli>(Clock::now() - generateStart).count();
+            const auto &asmGeometry = assembly.GetGeometry();
+            auto compCount = asmGeometry.Components.size();
+
+            vgo::BoundsCache bounds;
+            std::vector<vgo::DrawItem> drawItems;
+            glm::mat4 world;
+            int32_t firstId = 0;
+            vgo::MeshletCache meshlets;
+            std::vector<vgo::DrawItem> culledItems;
+            vgo::CullStats fitStats;
+            vgo::CullStats zoomStats;
+            vgo::ProtoIndex protoIndex;
+            int64_t selected = 0;
+            // 依次选中每个part第一个面的原型,在所有实例中查找
+            auto select = [&] {
+                selected = 0;
+                for (const auto &part : asmGeometry.Parts)
+                {
+                    if (part.ProtoFaceIndices.size() == 0)
+                    {
+                        continue;
+                    }
+                    for (const auto &ref : protoIndex.FindFace(part.ProtoFaceIndices[0]))
+                    {
+                        selected += static_cast<int64_t>(protoIndex.GetPartComponents(ref.PartIndex).size());
+                    }
+                }
+            };
+            auto fitCamera = [&](float orthoScale) {
+                glm::mat4 fitWorld = vgo::Mat4Identity;
+                if (!bounds.GetBounds().IsEmpty())
+                {
+                    asmGeometry.CreateAsmWorldRH(bounds.GetBounds().Min, bounds.GetBounds().Max, 1, 1, fitWorld);
+                }
+                return MakeCamera(fitWorld, orthoScale);
+            };
+            auto cull = [&](float orthoScale, vgo::CullStats &stats) {
+                stats = meshlets.Cull(asmGeometry, fitCamera(orthoScale), drawItems, culledItems);
+            };
+            // 在1000x1000的视图中框选中间200x200的区域
+            vgo::RectSelector selector;
+            std::vector<int32_t> selection;
+            auto selectRect = vgo::ScreenToNdcRect(400, 400, 600, 600, 1000, 1000);
+            auto selectReport = [&] { return ", \"selected\": " + std::to_string(selection.size()); };
+            std::vector<Stage> stages = {
+                {"bounds_box", [&] { bounds.Update(asmGeometry, vgo::BoundsMode::Box); }},
+                {"bounds_vertices", [&] { bounds.Update(asmGeometry, vgo::BoundsMode::Vertices); }},
+                {"create_asm_world", [&] { asmGeometry.CreateAsmWorldRH(1, 1, world); }},
+                {"comp_first_id_last", [&] { firstId = asmGeometry.GetCompFirstIdByIndex(compCount - 1); }},
+                {"draw_list", [&] { vgo::BuildDrawList(asmGeometry, [](int32_t) { return true; }, drawItems); }},
+                {"proto_index_build", [&] { protoIndex.Update(asmGeometry); }},
+                {"proto_face_select", select,
+                 [&] {
+                     std::ostringstream out;
+                     out << ", \"queries\": " << asmGeometry.Parts.size() << ", \"instances\": " << selected;
+                     return out.str();
+                 }},
+                {"meshlet_build", [&] { meshlets.Update(asmGeometry); }},
+                {"meshlet_cull_fit", [&] { cull(1.0f, fitStats); },
+                 [&] { return CullReport(fitStats, culledItems.size()); }},
+                {"meshlet_cull_zoom", [&] { cull(0.25f, zoomStats); },
+                 [&] { return CullReport(zoomStats, culledItems.size()); }},
+                {"select_update", [&] { selector.Update(bounds.GetCompBounds()); }},
+                {"select_rect_inside",
+                 [&] {
+                     selector.Select(asmGeometry, fitCamera(1.0f), selectRect, vgo::SelectMode::Inside, selection,
+                                     &meshlets);
+                 },
+                 selectReport},
+                {"select_rect_crossing",
+                 [&] {
+                     selector.Select(asmGeometry, fitCamera(1.0f), selectRect, vgo::SelectMode::Crossing, selection,
+                                     &meshlets);
+                 },
+                 selectReport},
+            };
+
+            json << (n == 0 ? "\n" : ",\n");
+            json << "    {\"components\": " << compCount << ", \"parts\": " << asmGeometry.Parts.size()
+                 << ", \"triangles\": " << assembly.GetTriangleCount() << ", \"generate_ms\": " << generateMs
+                 << ",\n     \"stages\": {";
+            for (size_t s = 0; s < stages.size(); s++)
+            {
+                auto ms = MedianMs(stages[s].Run, options.Repeat);
+                json << (s == 0 ? "" : ", ") << "\n       \"" << stages[s].Name << "\": {\"ms\": " << ms
+                     << ", \"ns_per_component\": " << ms * 1.0e6 / std::max(compCount, 1)
+                     << (stages[s].Report ? stages[s].Report() : "") << "}";
+                std::cerr << compCount << " " << stages[s].Name << ": " << ms << " ms" << std::endl;
+            }
+            json << "}}";
+            // 防止编译器把结果优化掉
+            if (firstId < 0 || world[3][3] != 1.0f)
+            {
+                std::cerr << "unexpected result" << std::endl;
+            }
+        }
+        json << "\n  ]\n}\n";
+
+        if (options.Out.empty())
+        {
+            std::cout << json.str();
+        }
+        else
+        {
+            std::ofstream file(options.Out);
+            file << json.str();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "SyntheticAssembly.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace vgo
+{
+
+namespace
+{
+constexpr float Pi = 3.14159265358979f;
+// 组件之间的间距,part半径在[1,1.5)之间
+constexpr float Spacing = 4.0f;
+
+template <typename T> UnSafeArray<T> MakeArray(std::vector<T> &vec)
+{
+    return UnSafeArray<T>(vec.data(), static_cast<int32_t>(vec.size()));
+}
+
+glm::vec4 MakeVertex(const glm::vec3 &pos, int32_t primitiveId)
+{
+    return glm::vec4(pos, std::bit_cast<float>(primitiveId));
+}
+} // namespace
+
+SyntheticDistribution ParseDistribution(const std::string &name)
+{
+    if (name == "grid")
+    {
+        return SyntheticDistribution::Grid;
+    }
+    if (name == "uniform")
+    {
+        return SyntheticDistribution::Uniform;
+    }
+    if (name == "clustered")
+    {
+        return SyntheticDistribution::Clustered;
+    }
+    throw std::runtime_error("Unknown distribution: " + name);
+}
+
+const char *DistributionName(SyntheticDistribution distribution)
+{
+    switch (distribution)
+    {
+    case SyntheticDistribution::Grid:
+        return "grid";
+    case SyntheticDistribution::Uniform:
+        return "uniform";
+    case SyntheticDistribution::Clustered:
+        return "clustered";
+    }
+    return "unknown";
+}
+
+SyntheticAssembly::SyntheticAssembly(const SyntheticParams &params)
+{
+    auto partCount = std::max<int32_t>(
+        1, static_cast<int32_t>(std::lround(params.CompCount * (1.0 - static_cast<double>(params.InstancingRatio)))));
+    partCount = std::min(partCount, std::max(params.CompCount, 1));
+    std::mt19937 random(params.Seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    arrays.resize(partCount);
+    parts.resize(partCount);
+    for (int32_t i = 0; i < partCount; i++)
+    {
+        BuildPart(i, params.TrianglesPerPart, 1.0f + 0.5f * unit(random));
+    }
+
+    comps.resize(params.CompCount);
+    auto side = std::max(1.0f, std::ceil(std::cbrt(static_cast<float>(params.CompCount))));
+    auto extent = side * Spacing;
+    std::vector<glm::vec3> clusters(std::max(1, params.CompCount / 1000));
+    for (auto &center : clusters)
+    {
+        center = glm::vec3(unit(random), unit(random), unit(random)) * extent;
+    }
+    std::normal_distribution<float> spread(0.0f, Spacing * 3.0f);
+    auto gridSide = static_cast<int32_t>(side);
+    for (int32_t i = 0; i < params.CompCount; i++)
+    {
+        glm::vec3 position;
+        switch (params.Distribution)
+        {
+        case SyntheticDistribution::Grid:
+            position = glm::vec3(static_cast<float>(i % gridSide), static_cast<float>(i / gridSide % gridSide),
+                                 static_cast<float>(i / gridSide / gridSide)) *
+                       Spacing;
+            break;
+        case SyntheticDistribution::Uniform:
+            position = glm::vec3(unit(random), unit(random), unit(random)) * extent;
+            break;
+        case SyntheticDistribution::Clustered:
+            position = clusters[random() % clusters.size()] + glm::vec3(spread(random), spread(random), spread(random));
+            break;
+        }
+        glm::vec3 axis(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f);
+        if (glm::dot(axis, axis) < 1e-6f)
+        {
+            axis = Vec3Unitz;
+        }
+        auto &comp = comps[i];
+        comp.PartIndex = i % partCount;
+        comp.CompMatrix = glm::rotate(glm::translate(Mat4Identity, position), unit(random) * 2.0f * Pi,
+                                      glm::normalize(axis));
+    }
+    geometry.Parts = MakeArray(parts);
+    geometry.Components = MakeArray(comps);
+}
+
+int64_t SyntheticAssembly::GetTriangleCount() const
+{
+    int64_t count = 0;
+    for (const auto &comp : comps)
+    {
+        count += parts[comp.PartIndex].FaceCount / 3;
+    }
+    return count;
+}
+
+void SyntheticAssembly::BuildPart(int32_t partIndex, int32_t triangles, float radius)
+{
+    // 三角形数量 = 2 * slices * (stacks - 1)
+    auto slices = std::max(3, static_cast<int32_t>(std::lround(std::sqrt(static_cast<float>(triangles)))));
+    auto stacks = std::max(2, static_cast<int32_t>(std::lround(triangles / (2.0f * slices))) + 1);
+    auto point = [&](int32_t stack, int32_t slice) {
+        float theta = Pi * stack / stacks;
+        float phi = 2.0f * Pi * (slice % slices) / slices;
+        return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)) * radius;
+    };
+
+    auto &a = arrays[partIndex];
+    // 每一带是一个面,顶点不和相邻的带共享,这样w才能保存面的id
+    auto addTriangle = [&a](int32_t faceId, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2) {
+        if (glm::dot(glm::cross(p1 - p0, p2 - p0), p0 + p1 + p2) < 0.0f)
+        {
+            std::swap(p1, p2);
+        }
+        for (const auto &p : {p0, p1, p2})
+        {
+            a.Indices.push_back(static_cast<int32_t>(a.Vertices.size()));
+            a.Vertices.push_back(MakeVertex(p, faceId));
+        }
+    };
+    auto protoBase = partIndex * (2 * stacks);
+    for (int32_t face = 0; face < stacks; face++)
+    {
+        a.FaceIndices.push_back(static_cast<int32_t>(a.Indices.size()));
+        a.ProtoFaceIndices.push_back(protoBase + face + 1);
+        for (int32_t j = 0; j < slices; j++)
+        {
+            if (face == 0)
+            {
+                addTriangle(face, point(0, 0), point(1, j), point(1, j + 1));
+            }
+            else if (face == stacks - 1)
+            {
+                addTriangle(face, point(stacks, 0), point(stacks - 1, j), point(stacks - 1, j + 1));
+            }
+            else
+            {
+                addTriangle(face, point(face, j), point(face + 1, j), point(face + 1, j + 1));
+                addTriangle(face, point(face, j), point(face + 1, j + 1), point(face, j + 1));
+            }
+        }
+    }
+    auto faceCount = static_cast<int32_t>(a.Indices.size());
+    a.FaceIndices.push_back(faceCount);
+
+    // 带之间的纬线作为边,边的起始索引相对EdgeStartIndex
+    for (int32_t ring = 1; ring < stacks; ring++)
+    {
+        auto edgeId = stacks + ring - 1;
+        a.EdgeIndices.push_back(static_cast<int32_t>(a.Indices.size()) - faceCount);
+        a.ProtoEdgeIndices.push_back(protoBase + edgeId + 1);
+        auto first = static_cast<int32_t>(a.Vertices.size());
+        for (int32_t j = 0; j < slices; j++)
+        {
+            a.Vertices.push_back(MakeVertex(point(ring, j), edgeId));
+        }
+        for (int32_t j = 0; j < slices; j++)
+        {
+            a.Indices.push_back(first + j);
+            a.Indices.push_back(first + (j + 1) % slices);
+        }
+    }
+    a.EdgeIndices.push_back(static_cast<int32_t>(a.Indices.size()) - faceCount);
+
+    auto &part = parts[partIndex];
+    part.Vertices = MakeArray(a.Vertices);
+    part.Indices = MakeArray(a.Indices);
+    part.FaceIndices = MakeArray(a.FaceIndices);
+    part.ProtoFaceIndices = MakeArray(a.ProtoFaceIndices);
+    part.EdgeIndices = MakeArray(a.EdgeIndices);
+    part.ProtoEdgeIndices = MakeArray(a.ProtoEdgeIndices);
+    part.FaceStartIndex = 0;
+    part.FaceCount = faceCount;
+    part.EdgeStartIndex = faceCount;
+    part.EdgeCount = static_cast<int32_t>(a.Indices.size()) - faceCount;
+    part.Box[0] = glm::vec3(-radius);
+    part.Box[1] = glm::vec3(radius);
+}
+} // namespace vgo
@@ -0,0 +1,65 @@
+#pragma once
+#include "Viewer.Geometry.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vgo
+{
+enum class SyntheticDistribution
+{
+    Grid,      // 规则网格
+    Uniform,   // 立方体内均匀随机
+    Clustered, // 若干个正态分布的团簇
+};
+
+struct SyntheticParams
+{
+    int32_t CompCount = 10000;
+    int32_t TrianglesPerPart = 256;
+    // 共享part的组件比例,part数量为CompCount*(1-InstancingRatio),至少一个
+    float InstancingRatio = 0.99f;
+    SyntheticDistribution Distribution = SyntheticDistribution::Uniform;
+    uint32_t Seed = 1;
+};
+
+SyntheticDistribution ParseDistribution(const std::string &name);
+
+const char *DistributionName(SyntheticDistribution distribution);
+
+// 生成由封闭球面part组成的装配体,每个part按纬度分带,每一带是一个面,带之间的纬线是边,
+// 顶点的w按位保存图元id,数组布局与.mem转换出来的PartGeometry一致
+class SyntheticAssembly
+{
+  public:
+    explicit SyntheticAssembly(const SyntheticParams &params);
+
+    SyntheticAssembly(const SyntheticAssembly &) = delete;
+    SyntheticAssembly &operator=(const SyntheticAssembly &) = delete;
+
+    const AsmGeometry &GetGeometry() const
+    {
+        return geometry;
+    }
+
+    int64_t GetTriangleCount() const;
+
+  private:
+    struct PartArrays
+    {
+        std::vector<glm::vec4> Vertices;
+        std::vector<int32_t> Indices;
+        std::vector<int32_t> FaceIndices;
+        std::vector<int32_t> ProtoFaceIndices;
+        std::vector<int32_t> EdgeIndices;
+        std::vector<int32_t> ProtoEdgeIndices;
+    };
+
+    std::vector<PartArrays> arrays;
+    std::vector<PartGeometry> parts;
+    std::vector<CompGeometry> comps;
+    AsmGeometry geometry;
+
+    void BuildPart(int32_t partIndex, int32_t triangles, float radius);
+};
+} // namespace vgo
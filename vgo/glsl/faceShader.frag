@@ -2,13 +2,13 @@
 
 // uniform vec3 lightPos; 
 // uniform vec3 lightColor;
-uniform vec4 objectColor;
 // uniform mat3 normalModel;
 
 
 in GS_Out{
     vec3 gs_normal;
     vec3 gs_posW;
+    flat vec4 gs_color;
 } gout;
 
 
@@ -30,6 +30,6 @@ void main()
     float diff = max(dot(gout.gs_normal, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
             
-    vec3 result = (ambient + diffuse) * objectColor.xyz;
-    FragColor = vec4(result, objectColor.w);
+    vec3 result = (ambient + diffuse) * gout.gs_color.xyz;
+    FragColor = vec4(result, gout.gs_color.w);
 }
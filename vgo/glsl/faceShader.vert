@@ -6,10 +6,17 @@ uniform mat4 g_View;
 uniform mat4 g_Proj;  
 uniform mat4 g_Translation;
 uniform mat4 g_Origin;
+// 每个组件占两个texel: [颜色rgba] [flags, faceBegin, faceEnd, 保留]
+// 同一个buffer按浮点读颜色,按无符号整数读第二个texel
+uniform samplerBuffer g_CompStates;
+uniform usamplerBuffer g_CompFlags;
+uniform int g_CompIndex;
+uniform vec4 highlightColor;
 
 out VS_Out{
     vec3 origW;
     vec3 posW;
+    flat vec4 color;
 } vout;
 
 void main()
@@ -20,5 +27,12 @@ void main()
     vec4 pos=g_World*orig;
     vout.origW=orig.xyz;
     vout.posW=pos.xyz;
+
+    vec4 color=texelFetch(g_CompStates,g_CompIndex*2);
+    ivec4 state=ivec4(texelFetch(g_CompFlags,g_CompIndex*2+1));
+    uint flags=uint(state.x);
+    int faceId=floatBitsToInt(vIn.w);
+    bool highlight=(flags&2u)!=0u||(faceId>=state.y&&faceId<state.z);
+    vout.color=highlight?vec4(mix(color.rgb,highlightColor.rgb,highlightColor.a),color.a):color;
     gl_Position=g_Proj*g_View*pos*g_Translation;
 }
\ No newline at end of file
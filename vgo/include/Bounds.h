@@ -0,0 +1,65 @@
+#pragma once
+#include "Viewer.Geometry.hpp"
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VGO_SSE2
+#endif
+
+namespace vgo
+{
+struct Aabb
+{
+    glm::vec3 Min{FLT_MAX, FLT_MAX, FLT_MAX};
+    glm::vec3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    bool IsEmpty() const
+    {
+        return Min.x > Max.x || Min.y > Max.y || Min.z > Max.z;
+    }
+
+    void Merge(const Aabb &other)
+    {
+        Min = glm::min(Min, other.Min);
+        Max = glm::max(Max, other.Max);
+    }
+};
+
+enum class BoundsMode
+{
+    // 变换part包围盒的8个角点,结果包含组件但不一定最紧
+    Box,
+    // 变换part所有面的顶点,结果最紧,未加载顶点的part退回Box
+    Vertices,
+};
+
+// 包围盒[min,max]经过trans后的轴对齐包围盒,等价于变换8个角点
+void TransformBox(const glm::mat4 &trans, const glm::vec3 &min, const glm::vec3 &max, Aabb &result);
+
+// indices引用的顶点经过trans后的轴对齐包围盒,顶点的w是图元id,按1处理
+void TransformPoints(const glm::mat4 &trans, const glm::vec4 *vertices, const int32_t *indices, int32_t count,
+                     Aabb &result);
+
+// 每个组件的世界包围盒,在UpdateGeometry时并行计算一次,供相机适配和远近裁剪面复用
+class BoundsCache
+{
+  public:
+    void Update(const AsmGeometry &asmGeometry, BoundsMode mode = BoundsMode::Box);
+
+    const std::vector<Aabb> &GetCompBounds() const
+    {
+        return compBounds;
+    }
+
+    const Aabb &GetBounds() const
+    {
+        return bounds;
+    }
+
+  private:
+    std::vector<Aabb> compBounds;
+    Aabb bounds;
+};
+} // namespace vgo
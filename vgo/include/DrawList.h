@@ -0,0 +1,38 @@
+#pragma once
+#include "Viewer.Geometry.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace vgo
+{
+// 一次glDrawElements,First和Count都以索引个数为单位
+struct DrawItem
+{
+    int32_t CompIndex;
+    int32_t PartIndex;
+    int32_t First;
+    int32_t Count;
+};
+
+// 按组件顺序生成面的绘制列表,visible(compIndex)为false的组件和没有面的part被跳过
+template <typename Visible>
+void BuildDrawList(const AsmGeometry &asmGeometry, Visible &&visible, std::vector<DrawItem> &items)
+{
+    items.clear();
+    auto compsCount = asmGeometry.Components.size();
+    for (int32_t i = 0; i < compsCount; i++)
+    {
+        if (!visible(i))
+        {
+            continue;
+        }
+        auto partIndex = asmGeometry.Components[i].PartIndex;
+        const auto &part = asmGeometry.Parts[partIndex];
+        if (part.FaceCount == 0)
+        {
+            continue;
+        }
+        items.push_back(DrawItem{i, partIndex, part.FaceStartIndex, part.FaceCount});
+    }
+}
+} // namespace vgo
@@ -44,6 +44,39 @@ struct CompGeometry
     float CompMatrix[16];
 };
 
+#define ComponentState_Visible 0b01
+#define ComponentState_Highlight 0b10
+
+// 组件的显示状态,按组件序号保存在GPU的状态缓冲中,布局与faceShader.vert中的两个texel一致
+typedef struct ComponentState
+{
+    float color[4];    // rgba
+    uint32_t flags;    // ComponentState_Visible | ComponentState_Highlight
+    int32_t faceBegin; // 高亮的面id区间[faceBegin, faceEnd)
+    int32_t faceEnd;
+    int32_t reserved;
+} ComponentState_t;
+
+// 原型面/边在一个part中对应的图元id区间[begin, end),图元id与顶点w中的id一致
+typedef struct ProtoRef
+{
+    int32_t partIndex;
+    int32_t begin;
+    int32_t end;
+} ProtoRef_t;
+
+// 最近一帧的meshlet剔除统计,单位是三角形
+typedef struct CullStats
+{
+    int64_t triangles;      // 剔除前可见组件的三角形总数
+    int64_t backfaceCulled; // 整个meshlet背向相机被剔除的三角形
+    int64_t frustumCulled;  // meshlet在视景体外被剔除的三角形
+} CullStats_t;
+
+// 框选模式: 窗选只选中完全在矩形内的组件,交叉选择选中与矩形相交的组件
+#define SelectMode_Inside 0
+#define SelectMode_Crossing 1
+
 typedef UnSafeArray_t UnSafeArray_PartGeometry_t;
 typedef UnSafeArray_t UnSafeArray_CompGeometry_t;
 
@@ -64,6 +97,31 @@ DLL_EXPORT void gl_control_render();
 
 DLL_EXPORT void gl_control_update_geometry(AsmGeometry *asmGeometry);
 
+DLL_EXPORT int32_t gl_control_load_model(char *path);
+
+DLL_EXPORT int32_t gl_control_snapshot(int32_t width, int32_t height, char *path);
+
+DLL_EXPORT void gl_control_set_component_states(const int32_t *ids, const ComponentState_t *states, int32_t n);
+
+DLL_EXPORT int32_t gl_control_pending_parts();
+
+DLL_EXPORT void gl_control_get_cull_stats(CullStats_t *stats);
+
+// 下面的查询返回内部数组的指针,在下一次更新几何之前有效,找不到时count为0
+DLL_EXPORT const ProtoRef_t *gl_control_find_proto_face(int32_t protoId, int32_t *count);
+
+DLL_EXPORT const ProtoRef_t *gl_control_find_proto_edge(int32_t protoId, int32_t *count);
+
+DLL_EXPORT const int32_t *gl_control_get_part_components(int32_t partIndex, int32_t *count);
+
+DLL_EXPORT int32_t gl_control_highlight_proto_face(int32_t protoId);
+
+// 按控件像素坐标框选可见组件并高亮,返回选中的组件个数;
+// 取消框选时只清除框选设置的高亮,通过gl_control_set_component_states设置的高亮保持不变
+DLL_EXPORT int32_t gl_control_select_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t mode);
+
+DLL_EXPORT const int32_t *gl_control_get_selection(int32_t *count);
+
 DLL_EXPORT void gl_control_mouse_down(KeyCode_t keycode, int32_t x, int32_t y);
 
 DLL_EXPORT void gl_control_mouse_up(KeyCode_t keycode, int32_t x, int32_t y);
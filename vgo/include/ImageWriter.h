@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace vgo
+{
+// 按从上到下的顺序逐行写入RGB8图像,不需要在内存中保留整张图
+class ImageWriter
+{
+  public:
+    virtual ~ImageWriter() = default;
+
+    // rgb是rows行紧密排列的像素,每行width*3字节
+    virtual void WriteRows(const uint8_t *rgb, int32_t rows) = 0;
+
+    // 写完所有行后调用,补齐文件尾
+    virtual void Finish() = 0;
+};
+
+// 根据扩展名创建写入器,支持.png和.ppm
+std::unique_ptr<ImageWriter> CreateImageWriter(const std::filesystem::path &path, int32_t width, int32_t height);
+} // namespace vgo
@@ -0,0 +1,71 @@
+#pragma once
+#include "DrawList.h"
+#include "Viewer.Geometry.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace vgo
+{
+constexpr int32_t MeshletMaxVertices = 64;
+constexpr int32_t MeshletMaxTriangles = 124;
+
+// part面索引中一段连续的三角形,包围球和法线锥都在part局部坐标系下
+struct Meshlet
+{
+    glm::vec3 Center;
+    float Radius;
+    // 所有三角形法线都在以ConeAxis为轴的锥内,ConeCutoff是锥半角的正弦,大于1表示不能做背面剔除
+    glm::vec3 ConeAxis;
+    float ConeCutoff;
+    // 以索引个数为单位
+    int32_t First;
+    int32_t Count;
+};
+
+// 按三角形原有顺序贪心切分part的面索引,不重排Indices,相邻meshlet的索引区间首尾相连
+void BuildMeshlets(const PartGeometry &part, std::vector<Meshlet> &meshlets);
+
+// 正交相机,View已经包含鼠标旋转和模型适配矩阵,Offset是投影之后的平移(g_Translation)
+struct CullCamera
+{
+    glm::mat4 View;
+    glm::mat4 Proj;
+    glm::vec2 Offset;
+};
+
+struct CullStats
+{
+    int64_t Triangles = 0;
+    int64_t BackfaceCulled = 0;
+    int64_t FrustumCulled = 0;
+
+    double GetCulledFraction() const
+    {
+        return Triangles == 0 ? 0.0 : static_cast<double>(BackfaceCulled + FrustumCulled) / Triangles;
+    }
+};
+
+// 每个part的meshlet,在UpdateGeometry时并行构建,延迟加载的part在加载后单独构建
+class MeshletCache
+{
+  public:
+    void Update(const AsmGeometry &asmGeometry);
+
+    void UpdatePart(int32_t partIndex, const PartGeometry &part);
+
+    const std::vector<Meshlet> &GetMeshlets(int32_t partIndex) const
+    {
+        return partMeshlets[partIndex];
+    }
+
+    // 剔除组件中背向相机和在屏幕外的meshlet,每个组件输出若干个不相邻的索引区间,顺序与items一致
+    // 没有meshlet的part(未加载)只做组件级的屏幕外剔除
+    CullStats Cull(const AsmGeometry &asmGeometry, const CullCamera &camera, const std::vector<DrawItem> &items,
+                   std::vector<DrawItem> &result);
+
+  private:
+    std::vector<std::vector<Meshlet>> partMeshlets;
+    std::vector<std::vector<DrawItem>> chunkItems;
+    std::vector<CullStats> chunkStats;
+};
+} // namespace vgo
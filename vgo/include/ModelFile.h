@@ -0,0 +1,151 @@
+#pragma once
+#include "Viewer.Geometry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace vgo
+{
+// v2模型容器(.vgo)的布局:
+// [ModelFileHeader][ModelPartEntry * PartCount][CompGeometry * CompCount][part chunk]...
+// 每个part chunk内部依次存放Vertices,Indices,FaceIndices,ProtoFaceIndices,EdgeIndices,ProtoEdgeIndices,
+// 所有表和数组的起始位置都按64字节对齐,未压缩的chunk可以直接映射使用
+constexpr uint32_t ModelFileMagic = 0x324F4756; // "VGO2"
+constexpr uint32_t ModelFileVersion = 2;
+constexpr uint64_t ModelFileAlignment = 64;
+constexpr int32_t ModelPartArrayCount = 6;
+
+enum class ChunkCompression : uint32_t
+{
+    None = 0,
+    Lz = 1,
+};
+
+struct ModelFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    int32_t PartCount;
+    int32_t CompCount;
+    uint64_t PartTableOffset;
+    uint64_t CompTableOffset;
+    uint64_t FileSize;
+    uint64_t Reserved;
+};
+
+struct ModelPartEntry
+{
+    uint64_t Offset;     // chunk在文件中的位置
+    uint64_t StoredSize; // chunk在文件中的字节数
+    uint64_t RawSize;    // 解压后的字节数
+    uint64_t Hash;       // 解压后内容的HashBytes
+    ChunkCompression Compression;
+    int32_t ArrayLengths[ModelPartArrayCount];
+    int32_t FaceStartIndex;
+    int32_t FaceCount;
+    int32_t EdgeStartIndex;
+    int32_t EdgeCount;
+    float Box[6]; // [min, max]
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(ModelFileHeader) == 48, "ModelFileHeader layout changed");
+static_assert(sizeof(ModelPartEntry) == 104, "ModelPartEntry layout changed");
+static_assert(sizeof(CompGeometry) == 68, "CompGeometry layout changed");
+
+struct AlignedDeleter
+{
+    void operator()(std::byte *ptr) const
+    {
+        ::operator delete[](ptr, std::align_val_t(ModelFileAlignment));
+    }
+};
+
+using AlignedBytes = std::unique_ptr<std::byte[], AlignedDeleter>;
+
+// chunk的完整性校验,按8字节字做FNV式的异或-乘法,不是标准FNV-1a,
+// 它的结果是文件格式的一部分,修改算法必须同时修改ModelFileVersion
+uint64_t HashBytes(const std::byte *data, size_t size);
+
+// 将asmGeometry写成v2容器,compress为true时对能压缩的chunk做LZ压缩
+void WriteModelFile(const AsmGeometry &asmGeometry, const std::filesystem::path &path, bool compress);
+
+// 旧版.mem顺序流(AsmGeometrySerializer生成)的完整读入,用于格式转换
+class MemModel
+{
+  public:
+    explicit MemModel(const std::filesystem::path &path);
+
+    MemModel(const MemModel &) = delete;
+    MemModel &operator=(const MemModel &) = delete;
+
+    const AsmGeometry &GetGeometry() const
+    {
+        return geometry;
+    }
+
+  private:
+    struct PartArrays
+    {
+        std::vector<glm::vec4> Vertices;
+        std::vector<int32_t> Indices;
+        std::vector<int32_t> FaceIndices;
+        std::vector<int32_t> ProtoFaceIndices;
+        std::vector<int32_t> EdgeIndices;
+        std::vector<int32_t> ProtoEdgeIndices;
+    };
+
+    std::vector<PartArrays> arrays;
+    std::vector<PartGeometry> parts;
+    std::vector<CompGeometry> comps;
+    AsmGeometry geometry;
+};
+
+// v2容器的延迟加载器,打开时只读取文件头,part目录和组件表,
+// part的数据在LoadPart时才从文件中读取,未加载的part只有Box,其余数组为空
+class ModelFile
+{
+  public:
+    explicit ModelFile(const std::filesystem::path &path);
+
+    ModelFile(const ModelFile &) = delete;
+    ModelFile &operator=(const ModelFile &) = delete;
+
+    const AsmGeometry &GetGeometry() const
+    {
+        return geometry;
+    }
+
+    int32_t GetPartCount() const
+    {
+        return header.PartCount;
+    }
+
+    const ModelPartEntry &GetPartEntry(int32_t partIndex) const
+    {
+        return entries[partIndex];
+    }
+
+    bool IsPartLoaded(int32_t partIndex) const
+    {
+        return chunks[partIndex] != nullptr;
+    }
+
+    const PartGeometry &LoadPart(int32_t partIndex);
+
+  private:
+    std::ifstream file;
+    ModelFileHeader header;
+    std::vector<ModelPartEntry> entries;
+    std::vector<PartGeometry> parts;
+    std::vector<CompGeometry> comps;
+    std::vector<AlignedBytes> chunks;
+    AsmGeometry geometry;
+
+    void Read(uint64_t offset, void *dst, uint64_t size);
+};
+} // namespace vgo
@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vgo
+{
+// 常驻的工作线程,ParallelFor每帧都会调用,不能每次创建和join线程
+class WorkerPool
+{
+  public:
+    // 第一次调用时创建hardware_concurrency-1个线程,之后一直复用,进程退出时不销毁
+    static WorkerPool &Get();
+
+    // 包括调用线程在内可以同时执行任务的线程数
+    int32_t GetConcurrency() const
+    {
+        return static_cast<int32_t>(threads.size()) + 1;
+    }
+
+    // fn(i)对[0,count)各执行一次,调用线程也参与执行,全部完成后返回;
+    // 多个线程同时调用时依次执行,在工作线程中嵌套调用时直接串行执行;
+    // 任务抛出异常时不再分发剩余任务,等所有线程退出后把第一个异常抛给调用者
+    void Run(int32_t count, const std::function<void(int32_t)> &fn);
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+  private:
+    WorkerPool();
+
+    void WorkerLoop();
+    void RunTasks(const std::function<void(int32_t)> &current, int32_t count);
+
+    std::vector<std::thread> threads;
+    // runMutex保证同一时间只有一批任务,mutex保护下面的状态
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int32_t)> *task = nullptr;
+    int32_t taskCount = 0;
+    int32_t nextTask = 0;
+    int32_t activeWorkers = 0;
+    uint64_t generation = 0;
+    // 本批任务中第一个异常
+    std::exception_ptr error;
+};
+
+// 把[0,count)切块分给多个线程,fn(begin,end)处理一个连续区间,区间起点总是grain的整数倍
+// 数据量不足两个grain时直接在当前线程执行
+template <typename Fn> void ParallelFor(int32_t count, int32_t grain, Fn &&fn)
+{
+    if (count <= grain)
+    {
+        fn(0, count);
+        return;
+    }
+    auto &pool = WorkerPool::Get();
+    int32_t workers = std::min(pool.GetConcurrency(), (count + grain - 1) / grain);
+    if (workers <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+    int32_t chunk = (count + workers - 1) / workers;
+    chunk = (chunk + grain - 1) / grain * grain;
+    pool.Run((count + chunk - 1) / chunk, [&fn, count, chunk](int32_t index) {
+        auto begin = index * chunk;
+        fn(begin, std::min(begin + chunk, count));
+    });
+}
+} // namespace vgo
@@ -0,0 +1,57 @@
+#pragma once
+#include "Viewer.Geometry.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vgo
+{
+// 原型面/边在一个part中对应的图元id区间[Begin,End),图元id与顶点w中的id一致,边的id排在面之后
+struct ProtoRef
+{
+    int32_t PartIndex;
+    int32_t Begin;
+    int32_t End;
+};
+
+// 原型id -> (part, 图元区间) 和 part -> 组件 的倒排索引,都以CSR数组保存,查询结果是连续的span,
+// 在下一次Update之前有效
+class ProtoIndex
+{
+  public:
+    // 重建全部索引
+    void Update(const AsmGeometry &asmGeometry);
+
+    // 只重建原型面/边的索引,用于延迟加载的part全部加载之后
+    void UpdatePrimitives(const AsmGeometry &asmGeometry);
+
+    std::span<const ProtoRef> FindFace(int32_t protoId) const
+    {
+        return faces.Find(protoId);
+    }
+
+    std::span<const ProtoRef> FindEdge(int32_t protoId) const
+    {
+        return edges.Find(protoId);
+    }
+
+    std::span<const int32_t> GetPartComponents(int32_t partIndex) const;
+
+  private:
+    struct Table
+    {
+        // Keys升序,Keys[i]对应Refs[Offsets[i], Offsets[i+1])
+        std::vector<int32_t> Keys;
+        std::vector<int32_t> Offsets;
+        std::vector<ProtoRef> Refs;
+
+        std::span<const ProtoRef> Find(int32_t protoId) const;
+    };
+
+    Table faces;
+    Table edges;
+    // partComps[partOffsets[p], partOffsets[p+1])是使用part p的组件,按组件序号升序
+    std::vector<int32_t> partOffsets;
+    std::vector<int32_t> partComps;
+};
+} // namespace vgo
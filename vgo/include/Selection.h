@@ -0,0 +1,50 @@
+#pragma once
+#include "Bounds.h"
+#include "Meshlet.h"
+#include "Viewer.Geometry.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace vgo
+{
+enum class SelectMode : int32_t
+{
+    // 组件完全在矩形内才选中
+    Inside = 0,
+    // 组件与矩形相交即选中
+    Crossing = 1,
+};
+
+// NDC中的选择矩形,正交相机下它和远近裁剪面围成原视景体的一个子视景体
+struct SelectRect
+{
+    glm::vec2 Min;
+    glm::vec2 Max;
+};
+
+// 控件像素坐标(原点在左上角)的两个角点转换为NDC矩形
+SelectRect ScreenToNdcRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t width, int32_t height);
+
+// 框选,不依赖OpenGL: 先用组件的世界包围盒批量分类(SSE每次4个),
+// 与矩形边界相交、无法确定的组件再用三角形(Crossing)或顶点(Inside)精确判断
+class RectSelector
+{
+  public:
+    // 包围盒按SoA保存,与BoundsCache::GetCompBounds一致,空包围盒的组件不会被选中
+    void Update(const std::vector<Aabb> &compBounds);
+
+    // 结果是升序的组件序号,meshlets可以为空,不为空时用来加速包围盒无法确定的组件
+    void Select(const AsmGeometry &asmGeometry, const CullCamera &camera, const SelectRect &rect, SelectMode mode,
+                std::vector<int32_t> &result, const MeshletCache *meshlets = nullptr);
+
+  private:
+    int32_t count = 0;
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+    std::vector<std::vector<int32_t>> chunkComps;
+};
+} // namespace vgo
@@ -29,6 +29,14 @@ void init_root_dir(const char *rootDir);
 template <typename T> struct UnSafeArray
 {
   public:
+    UnSafeArray() : ptr(nullptr), len(0)
+    {
+    }
+
+    UnSafeArray(T *ptr, int32_t len) : ptr(ptr), len(len)
+    {
+    }
+
     const T *data() const
     {
         return ptr;
@@ -128,13 +136,24 @@ struct AsmGeometry
         glm::vec3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
         for (const auto &comp : this->Components)
         {
+            // 旋转后只变换Box[0]和Box[1]得不到正确的范围,中心点按点变换,半长按|M|变换
             const auto &part = this->Parts[comp.PartIndex];
             const auto &trans = comp.CompMatrix;
-            glm::vec3 transMin = trans * glm::vec4(part.Box[0], 1.0f);
-            glm::vec3 transMax = trans * glm::vec4(part.Box[1], 1.0f);
-            min = glm::min(min, transMin);
-            max = glm::max(max, transMax);
+            glm::vec3 center = trans * glm::vec4((part.Box[0] + part.Box[1]) * 0.5f, 1.0f);
+            glm::vec3 extent = (part.Box[1] - part.Box[0]) * 0.5f;
+            glm::vec3 transExtent = glm::abs(glm::vec3(trans[0])) * extent.x +
+                                    glm::abs(glm::vec3(trans[1])) * extent.y +
+                                    glm::abs(glm::vec3(trans[2])) * extent.z;
+            min = glm::min(min, center - transExtent);
+            max = glm::max(max, center + transExtent);
         }
+        CreateAsmWorldRH(min, max, xSize, ySize, world);
+    }
+
+    // 由已经算好的世界包围盒[min,max]创建世界矩阵
+    void CreateAsmWorldRH(const glm::vec3 &min, const glm::vec3 &max, float xSize, float ySize,
+                          glm::mat4 &world) const
+    {
         glm::vec3 center = (min + max) * 0.5f;
         glm::vec3 size = max - min;
         float t = glm::min(size.z, glm::min(size.x, size.y));
@@ -0,0 +1,125 @@
+#include "Bounds.h"
+#include "Parallel.h"
+
+#ifdef VGO_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vgo
+{
+
+namespace
+{
+constexpr int32_t BoundsGrain = 4096;
+
+#ifdef VGO_SSE2
+void StoreAabb(__m128 min, __m128 max, Aabb &result)
+{
+    alignas(16) float lo[4];
+    alignas(16) float hi[4];
+    _mm_store_ps(lo, min);
+    _mm_store_ps(hi, max);
+    result.Min = glm::vec3(lo[0], lo[1], lo[2]);
+    result.Max = glm::vec3(hi[0], hi[1], hi[2]);
+}
+#endif
+} // namespace
+
+void TransformBox(const glm::mat4 &trans, const glm::vec3 &min, const glm::vec3 &max, Aabb &result)
+{
+    // 中心点按点变换,半长按|M|变换,与8个角点的结果一致
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extent = (max - min) * 0.5f;
+#ifdef VGO_SSE2
+    const float *m = &trans[0][0];
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 c = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(center.x)), _mm_mul_ps(c1, _mm_set1_ps(center.y))),
+                          _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(center.z)), c3));
+    __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(c0, absMask), _mm_set1_ps(extent.x)),
+                                     _mm_mul_ps(_mm_and_ps(c1, absMask), _mm_set1_ps(extent.y))),
+                          _mm_mul_ps(_mm_and_ps(c2, absMask), _mm_set1_ps(extent.z)));
+    StoreAabb(_mm_sub_ps(c, e), _mm_add_ps(c, e), result);
+#else
+    glm::vec3 c = glm::vec3(trans * glm::vec4(center, 1.0f));
+    glm::vec3 e = glm::abs(glm::vec3(trans[0])) * extent.x + glm::abs(glm::vec3(trans[1])) * extent.y +
+                  glm::abs(glm::vec3(trans[2])) * extent.z;
+    result.Min = c - e;
+    result.Max = c + e;
+#endif
+}
+
+void TransformPoints(const glm::mat4 &trans, const glm::vec4 *vertices, const int32_t *indices, int32_t count,
+                     Aabb &result)
+{
+#ifdef VGO_SSE2
+    const float *m = &trans[0][0];
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    __m128 min = _mm_set1_ps(FLT_MAX);
+    __m128 max = _mm_set1_ps(-FLT_MAX);
+    for (int32_t i = 0; i < count; i++)
+    {
+        __m128 v = _mm_loadu_ps(&vertices[indices[i]].x);
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))),
+                                         _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))), c3));
+        min = _mm_min_ps(min, p);
+        max = _mm_max_ps(max, p);
+    }
+    StoreAabb(min, max, result);
+#else
+    result = Aabb();
+    for (int32_t i = 0; i < count; i++)
+    {
+        glm::vec3 p = glm::vec3(trans * glm::vec4(glm::vec3(vertices[indices[i]]), 1.0f));
+        result.Min = glm::min(result.Min, p);
+        result.Max = glm::max(result.Max, p);
+    }
+#endif
+}
+
+void BoundsCache::Update(const AsmGeometry &asmGeometry, BoundsMode mode)
+{
+    auto count = asmGeometry.Components.size();
+    compBounds.resize(count);
+    std::vector<Aabb> partials(count == 0 ? 0 : (count + BoundsGrain - 1) / BoundsGrain);
+    ParallelFor(count, BoundsGrain, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++)
+        {
+            const auto &comp = asmGeometry.Components[i];
+            const auto &part = asmGeometry.Parts[comp.PartIndex];
+            if (mode == BoundsMode::Vertices && part.FaceCount > 0 && part.Vertices.size() > 0)
+            {
+                TransformPoints(comp.CompMatrix, part.Vertices.data(), part.Indices.data() + part.FaceStartIndex,
+                                part.FaceCount, compBounds[i]);
+            }
+            else
+            {
+                TransformBox(comp.CompMatrix, part.Box[0], part.Box[1], compBounds[i]);
+            }
+        }
+        // 每个grain单独汇总,避免线程之间共享总包围盒
+        for (int32_t g = begin / BoundsGrain; g * BoundsGrain < end; g++)
+        {
+            auto &partial = partials[g];
+            partial = Aabb();
+            auto last = std::min(end, (g + 1) * BoundsGrain);
+            for (int32_t i = std::max(begin, g * BoundsGrain); i < last; i++)
+            {
+                partial.Merge(compBounds[i]);
+            }
+        }
+    });
+    bounds = Aabb();
+    for (const auto &partial : partials)
+    {
+        bounds.Merge(partial);
+    }
+}
+} // namespace vgo
@@ -1,6 +1,14 @@
+#include "Bounds.h"
+#include "DrawList.h"
 #include "GLRender.h"
+#include "ImageWriter.h"
+#include "Meshlet.h"
+#include "ModelFile.h"
+#include "ProtoIndex.h"
+#include "Selection.h"
 #include "Viewer.Geometry.hpp"
 #include "glad/glad.h"
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <glm/ext/matrix_clip_space.hpp>
@@ -107,6 +115,16 @@ class Shader
         glUniform4fv(location, 1, &value[0]);
     }
 
+    void SetUniform(const std::string &name, int32_t value)
+    {
+        GLint location = glGetUniformLocation(_program, name.c_str());
+        if (location == -1)
+        {
+            throw std::runtime_error("Uniform not found: " + name);
+        }
+        glUniform1i(location, value);
+    }
+
     void SetUniform(const std::string &name, const glm::mat3 &value)
     {
         GLint location = glGetUniformLocation(_program, name.c_str());
@@ -169,19 +187,24 @@ class PartBuffers
         glGenBuffers(length, ebos);
         for (int32_t i = 0; i < length; i++)
         {
-            auto &part = asmGeo.Parts[i];
-            glBindVertexArray(vaos[i]);
-            glBindBuffer(GL_ARRAY_BUFFER, vbos[i]);
-            glBufferData(GL_ARRAY_BUFFER, part.Vertices.size() * sizeof(glm::vec4), part.Vertices.begin(),
-                         GL_STATIC_DRAW);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebos[i]);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, part.Indices.size() * sizeof(int32_t), part.Indices.begin(),
-                         GL_STATIC_DRAW);
-            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
-            glEnableVertexAttribArray(0);
+            Upload(i, asmGeo.Parts[i]);
         }
     }
 
+    // 重新上传一个part的顶点和索引,用于延迟加载的part
+    void Upload(int32_t partIndex, const PartGeometry &part)
+    {
+        glBindVertexArray(vaos[partIndex]);
+        glBindBuffer(GL_ARRAY_BUFFER, vbos[partIndex]);
+        glBufferData(GL_ARRAY_BUFFER, part.Vertices.size() * sizeof(glm::vec4), part.Vertices.begin(),
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebos[partIndex]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, part.Indices.size() * sizeof(int32_t), part.Indices.begin(),
+                     GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
+        glEnableVertexAttribArray(0);
+    }
+
     int32_t GetLength()
     {
         return this->length;
@@ -218,6 +241,283 @@ class PartBuffers
     GLuint *ebos;
 };
 
+// 组件显示状态的GPU缓冲(texture buffer),CPU端保留一份副本,
+// 修改时只标记所在的页,Flush时把连续的脏页合并成一次glBufferSubData
+static_assert(sizeof(ComponentState_t) == 2 * sizeof(glm::vec4), "ComponentState must be two RGBA32F texels");
+
+class ComponentStateBuffer
+{
+  public:
+    ComponentStateBuffer()
+    {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &texture);
+        glGenTextures(1, &flagsTexture);
+        Reset(0);
+    }
+
+    void Reset(int32_t count)
+    {
+        states.assign(count, DefaultState());
+        dirtyPages.assign((count + PageSize - 1) / PageSize, false);
+        // texture buffer不能为空,至少分配一个状态
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, glm::max(count, 1) * sizeof(ComponentState_t),
+                     count == 0 ? nullptr : states.data(), GL_DYNAMIC_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        // flags和面id区间按整数读取,避免驱动把它们当作非规格化浮点数清零
+        glBindTexture(GL_TEXTURE_BUFFER, flagsTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, buffer);
+    }
+
+    void Set(const int32_t *ids, const ComponentState_t *src, int32_t n)
+    {
+        auto count = static_cast<int32_t>(states.size());
+        for (int32_t i = 0; i < n; i++)
+        {
+            auto id = ids[i];
+            if (id < 0 || id >= count)
+            {
+                continue;
+            }
+            states[id] = src[i];
+            dirtyPages[id / PageSize] = true;
+        }
+    }
+
+    void SetHighlight(int32_t id, bool highlight)
+    {
+        if (id < 0 || id >= static_cast<int32_t>(states.size()))
+        {
+            return;
+        }
+        auto &flags = states[id].flags;
+        flags = highlight ? (flags | ComponentState_Highlight) : (flags & ~ComponentState_Highlight);
+        dirtyPages[id / PageSize] = true;
+    }
+
+    // 只修改高亮的面id区间,保留组件的颜色和flags
+    void SetFaceRange(int32_t id, int32_t faceBegin, int32_t faceEnd)
+    {
+        if (id < 0 || id >= static_cast<int32_t>(states.size()))
+        {
+            return;
+        }
+        states[id].faceBegin = faceBegin;
+        states[id].faceEnd = faceEnd;
+        dirtyPages[id / PageSize] = true;
+    }
+
+    // 面id区间仍是[faceBegin,faceEnd)时才清除,保留之后被其它调用修改过的区间
+    void ClearFaceRange(int32_t id, int32_t faceBegin, int32_t faceEnd)
+    {
+        if (id < 0 || id >= static_cast<int32_t>(states.size()) || states[id].faceBegin != faceBegin ||
+            states[id].faceEnd != faceEnd)
+        {
+            return;
+        }
+        SetFaceRange(id, 0, 0);
+    }
+
+    void Flush()
+    {
+        auto pageCount = static_cast<int32_t>(dirtyPages.size());
+        bool bound = false;
+        for (int32_t page = 0; page < pageCount;)
+        {
+            if (!dirtyPages[page])
+            {
+                page++;
+                continue;
+            }
+            auto first = page;
+            while (page < pageCount && dirtyPages[page])
+            {
+                dirtyPages[page++] = false;
+            }
+            if (!bound)
+            {
+                glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+                bound = true;
+            }
+            auto begin = first * PageSize;
+            auto end = glm::min(page * PageSize, static_cast<int32_t>(states.size()));
+            glBufferSubData(GL_TEXTURE_BUFFER, begin * sizeof(ComponentState_t),
+                            (end - begin) * sizeof(ComponentState_t), states.data() + begin);
+        }
+    }
+
+    void Bind(GLenum colorUnit, GLenum flagsUnit)
+    {
+        glActiveTexture(colorUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glActiveTexture(flagsUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, flagsTexture);
+    }
+
+    bool IsVisible(int32_t index) const
+    {
+        return (states[index].flags & ComponentState_Visible) != 0;
+    }
+
+    bool IsHighlighted(int32_t index) const
+    {
+        return (states[index].flags & ComponentState_Highlight) != 0;
+    }
+
+    ~ComponentStateBuffer()
+    {
+        glDeleteTextures(1, &flagsTexture);
+        glDeleteTextures(1, &texture);
+        glDeleteBuffers(1, &buffer);
+    }
+
+  private:
+    static constexpr int32_t PageSize = 256;
+
+    GLuint buffer;
+    // 同一个buffer的两个视图: RGBA32F读颜色,RGBA32UI读flags和面id区间
+    GLuint texture;
+    GLuint flagsTexture;
+    std::vector<ComponentState_t> states;
+    std::vector<bool> dirtyPages;
+
+    static ComponentState_t DefaultState()
+    {
+        return ComponentState_t{{0.5882353f, 0.5882353f, 0.5882353f, 1.0f}, ComponentState_Visible, 0, 0, 0};
+    }
+};
+
+// 离屏渲染目标,颜色和深度都使用renderbuffer
+class OffscreenTarget
+{
+  public:
+    OffscreenTarget(int32_t width, int32_t height)
+    {
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(2, rbos);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbos[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbos[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbos[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbos[1]);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            glDeleteFramebuffers(1, &fbo);
+            glDeleteRenderbuffers(2, rbos);
+            throw std::runtime_error("Offscreen framebuffer incomplete");
+        }
+    }
+
+    void Bind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    }
+
+    ~OffscreenTarget()
+    {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(2, rbos);
+    }
+
+  private:
+    GLuint fbo;
+    GLuint rbos[2];
+};
+
+// 两个PBO交替回读分块,读取当前分块的同时把上一个分块复制到像素条中
+class PixelReader
+{
+  public:
+    PixelReader(int32_t tileWidth, int32_t tileHeight)
+    {
+        glGenBuffers(2, pbos);
+        for (auto pbo : pbos)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(tileWidth) * tileHeight * 4, nullptr,
+                         GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    // 异步读取当前FBO左上角width*height的区域,x是分块在图片中的列
+    void Read(int32_t x, int32_t width, int32_t height)
+    {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        auto &tile = tiles[current];
+        tile = {x, width, height, true};
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[current]);
+        glReadPixels(0, viewport[3] - height, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        current ^= 1;
+    }
+
+    // 复制上一次Read的结果,strip每行imageWidth个RGB像素
+    void CopyPrevious(uint8_t *strip, int32_t imageWidth)
+    {
+        Copy(current, strip, imageWidth);
+    }
+
+    void Flush(uint8_t *strip, int32_t imageWidth)
+    {
+        Copy(current ^ 1, strip, imageWidth);
+    }
+
+    ~PixelReader()
+    {
+        glDeleteBuffers(2, pbos);
+    }
+
+  private:
+    struct Tile
+    {
+        int32_t x;
+        int32_t width;
+        int32_t height;
+        bool pending;
+    };
+
+    GLuint pbos[2];
+    Tile tiles[2]{};
+    int32_t current = 0;
+
+    void Copy(int32_t index, uint8_t *strip, int32_t imageWidth)
+    {
+        auto &tile = tiles[index];
+        if (!tile.pending)
+        {
+            return;
+        }
+        tile.pending = false;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[index]);
+        auto pixels = static_cast<const uint8_t *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+        if (pixels == nullptr)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            throw std::runtime_error("Failed to map pixel buffer");
+        }
+        // PBO中的行从下往上排列
+        for (int32_t row = 0; row < tile.height; row++)
+        {
+            auto src = pixels + static_cast<size_t>(tile.height - 1 - row) * tile.width * 4;
+            auto dst = strip + (static_cast<size_t>(row) * imageWidth + tile.x) * 3;
+            for (int32_t i = 0; i < tile.width; i++)
+            {
+                dst[i * 3] = src[i * 4];
+                dst[i * 3 + 1] = src[i * 4 + 1];
+                dst[i * 3 + 2] = src[i * 4 + 2];
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+};
+
 struct VSConstantBuffer
 {
     glm::mat4 world;
@@ -240,6 +540,8 @@ struct VSConstantBuffer
 struct PSConstantBuffer
 {
     glm::vec4 objColor = glm::vec4(0.5882353f, 0.5882353f, 0.5882353f, 1.0f);
+    // rgb是高亮颜色,a是与组件颜色的混合比例
+    glm::vec4 highlightColor = glm::vec4(1.0f, 0.6f, 0.0f, 0.7f);
 };
 
 
@@ -277,10 +579,133 @@ class GlRender
         mouseYOffset = 0;
 
         vsConstantBuffer = VSConstantBuffer();
+        bounds.Update(asmGeometry);
+        meshlets.Update(asmGeometry);
+        protoIndex.Update(asmGeometry);
+        highlightedFaces.clear();
+        selector.Update(bounds.GetCompBounds());
+        selectedComps.clear();
+        selectionHighlight.assign(asmGeometry.Components.size(), false);
+        const auto &asmBounds = bounds.GetBounds();
+        if (asmBounds.IsEmpty())
+        {
+            world = Mat4Identity;
+        }
+        else
+        {
+            asmGeometry.CreateAsmWorldRH(asmBounds.Min, asmBounds.Max, 1, 1, world);
+        }
+        FitClipPlanes();
         UpdateProjMatrix();
-        asmGeometry.CreateAsmWorldRH(1, 1, world);
         partBuffers = std::make_unique<PartBuffers>(asmGeometry);
+        compStates.Reset(asmGeometry.Components.size());
         geometry = asmGeometry;
+        modelFile.reset();
+        nextStreamPart = 0;
+    }
+
+    // 打开v2模型,只读取目录和组件表,part数据在之后的Render中逐步加载
+    void LoadModel(const std::filesystem::path &path)
+    {
+        auto model = std::make_unique<ModelFile>(path);
+        UpdateGeometry(model->GetGeometry());
+        modelFile = std::move(model);
+    }
+
+    void SetComponentStates(const int32_t *ids, const ComponentState_t *states, int32_t n)
+    {
+        compStates.Set(ids, states, n);
+        // 调用者重新设置过的组件,高亮位归调用者所有,取消框选时不再清除
+        for (int32_t i = 0; i < n; i++)
+        {
+            if (ids[i] >= 0 && ids[i] < static_cast<int32_t>(selectionHighlight.size()))
+            {
+                selectionHighlight[ids[i]] = false;
+            }
+        }
+    }
+
+    const ProtoIndex &GetProtoIndex() const
+    {
+        return protoIndex;
+    }
+
+    // 高亮所有实例中原型id为protoId的面,上一次原型面高亮会先被清除,返回被高亮的组件个数
+    // 一个part中同一原型对应多个不相邻的面时,只高亮第一段
+    int32_t HighlightProtoFace(int32_t protoId)
+    {
+        // 之后通过SetComponentStates修改过面区间的组件保留新的区间
+        for (const auto &face : highlightedFaces)
+        {
+            compStates.ClearFaceRange(face.CompIndex, face.FaceBegin, face.FaceEnd);
+        }
+        highlightedFaces.clear();
+        int32_t lastPart = -1;
+        for (const auto &ref : protoIndex.FindFace(protoId))
+        {
+            if (ref.PartIndex == lastPart)
+            {
+                continue;
+            }
+            lastPart = ref.PartIndex;
+            for (auto comp : protoIndex.GetPartComponents(ref.PartIndex))
+            {
+                compStates.SetFaceRange(comp, ref.Begin, ref.End);
+                highlightedFaces.push_back(FaceHighlight{comp, ref.Begin, ref.End});
+            }
+        }
+        return static_cast<int32_t>(highlightedFaces.size());
+    }
+
+    // 框选可见组件并高亮,上一次框选的高亮会先被清除,返回选中的组件个数
+    int32_t RectSelect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, SelectMode mode)
+    {
+        ClearSelection();
+        auto rect = ScreenToNdcRect(x0, y0, x1, y1, width, height);
+        selector.Select(geometry, GetCullCamera(GetSceneWorld()), rect, mode, selectResult, &meshlets);
+        for (auto comp : selectResult)
+        {
+            if (compStates.IsVisible(comp))
+            {
+                // 已经被调用者高亮的组件只加入选择,不记录为框选设置的高亮
+                if (!compStates.IsHighlighted(comp))
+                {
+                    compStates.SetHighlight(comp, true);
+                    selectionHighlight[comp] = true;
+                }
+                selectedComps.push_back(comp);
+            }
+        }
+        return static_cast<int32_t>(selectedComps.size());
+    }
+
+    // 取消上一次框选的高亮,只清除框选自己设置的高亮位
+    void ClearSelection()
+    {
+        for (auto comp : selectedComps)
+        {
+            if (selectionHighlight[comp])
+            {
+                compStates.SetHighlight(comp, false);
+                selectionHighlight[comp] = false;
+            }
+        }
+        selectedComps.clear();
+    }
+
+    const std::vector<int32_t> &GetSelection() const
+    {
+        return selectedComps;
+    }
+
+    const CullStats &GetCullStats() const
+    {
+        return cullStats;
+    }
+
+    int32_t GetPendingPartCount() const
+    {
+        return modelFile == nullptr ? 0 : modelFile->GetPartCount() - nextStreamPart;
     }
 
     void GLControlResize(GLuint width, GLuint height)
@@ -298,16 +723,118 @@ class GlRender
             first = false;
             return;
         }
+        StreamParts();
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        DrawScene();
+    }
 
-        auto xRadians = glm::radians(mouseXOffset);
-        auto yRadians = glm::radians(mouseYOffset);
-        glm::mat4 W =
-            glm::rotate(Mat4Identity, yRadians, Vec3Unitx) * glm::rotate(Mat4Identity, xRadians, Vec3Unity) * world;
+    // 用当前相机把场景分块渲染到离屏FBO,通过两个PBO交替回读,边渲染边写入图片
+    void Snapshot(int32_t imageWidth, int32_t imageHeight, const std::filesystem::path &path)
+    {
+        auto writer = CreateImageWriter(path, imageWidth, imageHeight);
+        while (GetPendingPartCount() > 0)
+        {
+            StreamParts();
+        }
+
+        GLint maxViewport[2];
+        GLint maxRenderbuffer;
+        glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+        glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+        int32_t maxTile = glm::min(glm::min(maxViewport[0], maxViewport[1]), glm::min(maxRenderbuffer, MaxSnapshotTile));
+        int32_t tileWidth = glm::min(imageWidth, maxTile);
+        // 一行分块对应的像素条要留在内存里等待写出,高度取小一些
+        int32_t tileHeight = glm::min(imageHeight, glm::min(maxTile, MaxSnapshotStrip));
+        int32_t columns = (imageWidth + tileWidth - 1) / tileWidth;
+        int32_t rows = (imageHeight + tileHeight - 1) / tileHeight;
+
+        // 无论是否抛出异常,退出时都恢复相机,剔除统计,framebuffer,viewport和回读对齐,
+        // 分块的DrawScene不应改变GetCullStats看到的上一帧结果; 声明在target和reader之前,最后析构
+        struct RestoreState
+        {
+            GlRender &render;
+            GLint framebuffer;
+            GLint viewport[4];
+            GLint packAlignment;
+            glm::mat4 projection;
+            glm::mat4 translation;
+            CullStats cullStats;
+
+            explicit RestoreState(GlRender &render)
+                : render(render), projection(render.vsConstantBuffer.projection),
+                  translation(render.vsConstantBuffer.translation), cullStats(render.cullStats)
+            {
+                glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+                glGetIntegerv(GL_VIEWPORT, viewport);
+                glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+            }
+
+            ~RestoreState()
+            {
+                render.vsConstantBuffer.projection = projection;
+                render.vsConstantBuffer.translation = translation;
+                render.cullStats = cullStats;
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+                glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+            }
+        };
+        RestoreState restore(*this);
+        const auto &previousTranslation = restore.translation;
+
+        OffscreenTarget target(tileWidth, tileHeight);
+        PixelReader reader(tileWidth, tileHeight);
+        std::vector<uint8_t> strip(static_cast<size_t>(imageWidth) * tileHeight * 3);
+        glViewport(0, 0, tileWidth, tileHeight);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        // 图片从上到下,每个分块取正交视景体中对应的一部分
+        auto aspectRatio = static_cast<float>(imageWidth) / static_cast<float>(imageHeight);
+        float left = -orthoScale * aspectRatio;
+        float top = orthoScale;
+        float pixelSize = 2.0f * orthoScale / static_cast<float>(imageHeight);
+        float tileScaleX = static_cast<float>(imageWidth) / static_cast<float>(tileWidth);
+        float tileScaleY = static_cast<float>(imageHeight) / static_cast<float>(tileHeight);
+        for (int32_t row = 0; row < rows; row++)
+        {
+            for (int32_t column = 0; column < columns; column++)
+            {
+                int32_t x0 = column * tileWidth;
+                int32_t y0 = row * tileHeight;
+                float tileLeft = left + x0 * pixelSize;
+                float tileTop = top - y0 * pixelSize;
+                vsConstantBuffer.projection =
+                    glm::ortho(tileLeft, tileLeft + tileWidth * pixelSize, tileTop - tileHeight * pixelSize, tileTop,
+                               nearPlane, farPlane);
+                // g_Translation在投影之后生效,平移量要按分块的放大倍数缩放
+                vsConstantBuffer.translation = previousTranslation;
+                vsConstantBuffer.translation[0][3] *= tileScaleX;
+                vsConstantBuffer.translation[1][3] *= tileScaleY;
+                target.Bind();
+                glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                DrawScene();
+                reader.Read(x0, glm::min(tileWidth, imageWidth - x0), glm::min(tileHeight, imageHeight - y0));
+                reader.CopyPrevious(strip.data(), imageWidth);
+                // 上一个分块是它那一行的最后一块时,这一行像素条已经完整
+                if (column == 0 && row > 0)
+                {
+                    writer->WriteRows(strip.data(), tileHeight);
+                }
+            }
+        }
+        reader.Flush(strip.data(), imageWidth);
+        writer->WriteRows(strip.data(), imageHeight - (rows - 1) * tileHeight);
+        writer->Finish();
+
+    }
+
+    void DrawScene()
+    {
+        glm::mat4 W = GetSceneWorld();
 
         vsConstantBuffer.world = W;
-        psConstantBuffer.objColor = glm::vec4(0.5882353f, 0.5882353f, 0.5882353f, 1.0f);
 
         glEnable(GL_POLYGON_OFFSET_FILL);
         faceShader.Use();
@@ -319,19 +846,34 @@ class GlRender
         faceShader.SetUniform("g_View", vsConstantBuffer.view);
         faceShader.SetUniform("g_Proj", vsConstantBuffer.projection);
         faceShader.SetUniform("g_Translation", vsConstantBuffer.translation);
-        faceShader.SetUniform("objectColor", psConstantBuffer.objColor);
-        auto compsCount = geometry.Components.size();
-        for (int32_t i = 0; i < compsCount; i++)
+        faceShader.SetUniform("highlightColor", psConstantBuffer.highlightColor);
+        compStates.Flush();
+        compStates.Bind(GL_TEXTURE0, GL_TEXTURE1);
+        faceShader.SetUniform("g_CompStates", 0);
+        faceShader.SetUniform("g_CompFlags", 1);
+        BuildDrawList(geometry, [this](int32_t i) { return compStates.IsVisible(i); }, drawItems);
+        cullStats = meshlets.Cull(geometry, GetCullCamera(W), drawItems, culledItems);
+        auto itemsCount = culledItems.size();
+        for (size_t i = 0; i < itemsCount;)
         {
-            auto &comp = geometry.Components[i];
-            auto &part = geometry.Parts[comp.PartIndex];
-            faceShader.SetUniform("g_Origin", comp.CompMatrix);
+            // 同一组件剔除后剩下的区间用一次glMultiDrawElements提交
+            auto compIndex = culledItems[i].CompIndex;
+            auto partIndex = culledItems[i].PartIndex;
+            drawCounts.clear();
+            drawOffsets.clear();
+            for (; i < itemsCount && culledItems[i].CompIndex == compIndex; i++)
+            {
+                drawCounts.push_back(culledItems[i].Count);
+                drawOffsets.push_back((const void *)(culledItems[i].First * sizeof(int32_t)));
+            }
+            faceShader.SetUniform("g_Origin", geometry.Components[compIndex].CompMatrix);
+            faceShader.SetUniform("g_CompIndex", compIndex);
             GLuint vao, ebo;
-            if (partBuffers->TryGetPartBuffer(comp.PartIndex, vao, ebo))
+            if (partBuffers->TryGetPartBuffer(partIndex, vao, ebo))
             {
                 glBindVertexArray(vao);
-                glDrawElements(GL_TRIANGLES, part.FaceCount, GL_UNSIGNED_INT,
-                               (void *)(part.FaceStartIndex * sizeof(int32_t)));
+                glMultiDrawElements(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(),
+                                    static_cast<GLsizei>(drawCounts.size()));
             }
         }
 
@@ -361,8 +903,17 @@ class GlRender
 
     void MouseDown(KeyCode code, int32_t x, int32_t y)
     {
-        lastX = static_cast<float>(x);
-        lastY = static_cast<float>(y);
+        // 左键的坐标是乘过缩放的像素坐标,只作为框选的起点,不能覆盖旋转和平移使用的lastX/lastY
+        if (code == KeyCode::Left)
+        {
+            selectStartX = x;
+            selectStartY = y;
+        }
+        else
+        {
+            lastX = static_cast<float>(x);
+            lastY = static_cast<float>(y);
+        }
         keyCode = keyCode | code;
     }
 
@@ -370,17 +921,23 @@ class GlRender
     {
         if (code == KeyCode::Left && keyCode == KeyCode::Left)
         {
-            // highlight
+            // 从左往右拖是窗选,从右往左拖是交叉选择,拖动距离太小时不处理
+            if (glm::abs(x - selectStartX) >= MinSelectDrag || glm::abs(y - selectStartY) >= MinSelectDrag)
+            {
+                RectSelect(selectStartX, selectStartY, x, y,
+                           x >= selectStartX ? SelectMode::Inside : SelectMode::Crossing);
+            }
+            else
+            {
+                // 单击空白处取消上一次框选
+                ClearSelection();
+            }
         }
         keyCode = keyCode & (~code);
     }
 
     void MouseMove(int32_t x, int32_t y)
     {
-        if (keyCode != KeyCode::Middle && keyCode != KeyCode::ControlLeft)
-        {
-            return;
-        }
         auto xPosIn = x;
         auto yPosIn = y;
 
@@ -390,8 +947,13 @@ class GlRender
         float xOffset = xPos - lastX;
         float yOffset = lastY - yPos; // reversed since y-coordinates go from bottom to top
 
+        // 没有拖动时也记录光标位置,按下Ctrl平移时从当前位置开始,不会跳动
         lastX = xPos;
         lastY = yPos;
+        if (keyCode != KeyCode::Middle && keyCode != KeyCode::ControlLeft)
+        {
+            return;
+        }
         switch (keyCode)
         {
         case KeyCode::Middle:
@@ -431,6 +993,8 @@ class GlRender
     float mouseXOffset{0};
     float mouseYOffset{0};
     float orthoScale{1.0f};
+    float nearPlane{0.1f};
+    float farPlane{100.0f};
     glm::mat4 world;
 
     VSConstantBuffer vsConstantBuffer;
@@ -444,8 +1008,64 @@ class GlRender
 
     std::unique_ptr<PartBuffers> partBuffers;
 
+    ComponentStateBuffer compStates;
+
+    std::vector<DrawItem> drawItems;
+
+    MeshletCache meshlets;
+
+    // meshlet剔除后的绘制区间,以及上一次绘制的剔除统计
+    std::vector<DrawItem> culledItems;
+
+    std::vector<GLsizei> drawCounts;
+
+    std::vector<const void *> drawOffsets;
+
+    // 最近一帧的剔除统计,截图时是最后一个分块的统计
+    CullStats cullStats;
+
+    ProtoIndex protoIndex;
+
+    // 上一次HighlightProtoFace设置的组件和面区间
+    struct FaceHighlight
+    {
+        int32_t CompIndex;
+        int32_t FaceBegin;
+        int32_t FaceEnd;
+    };
+    std::vector<FaceHighlight> highlightedFaces;
+
+    RectSelector selector;
+
+    std::vector<int32_t> selectResult;
+
+    // 上一次框选选中并高亮的可见组件
+    std::vector<int32_t> selectedComps;
+
+    // 按组件索引记录高亮位是否由框选设置
+    std::vector<bool> selectionHighlight;
+
+    int32_t selectStartX = 0;
+
+    int32_t selectStartY = 0;
+
+    static constexpr int32_t MinSelectDrag = 3;
+
     AsmGeometry geometry;
 
+    BoundsCache bounds;
+
+    std::unique_ptr<ModelFile> modelFile;
+
+    int32_t nextStreamPart = 0;
+
+    static constexpr int32_t MaxSnapshotTile = 4096;
+
+    static constexpr int32_t MaxSnapshotStrip = 1024;
+
+    // 每帧加载part的时间预算,至少加载一个
+    static constexpr std::chrono::milliseconds StreamBudget{8};
+
     GLuint width;
 
     GLuint height;
@@ -456,11 +1076,78 @@ class GlRender
 
     float lastY = 0.0f;
 
+    void StreamParts()
+    {
+        if (modelFile == nullptr)
+        {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool streamed = false;
+        while (nextStreamPart < modelFile->GetPartCount())
+        {
+            streamed = true;
+            auto partIndex = nextStreamPart++;
+            try
+            {
+                const auto &part = modelFile->LoadPart(partIndex);
+                partBuffers->Upload(partIndex, part);
+                meshlets.UpdatePart(partIndex, part);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Failed to load part " << partIndex << ": " << e.what() << std::endl;
+            }
+            if (std::chrono::steady_clock::now() - start > StreamBudget)
+            {
+                break;
+            }
+        }
+        // 原型id保存在part数据中,全部part加载之后再建立原型索引
+        if (streamed && nextStreamPart == modelFile->GetPartCount())
+        {
+            protoIndex.UpdatePrimitives(geometry);
+        }
+    }
+
+    // 鼠标旋转之后的模型矩阵,对应着色器中的g_World
+    glm::mat4 GetSceneWorld() const
+    {
+        auto xRadians = glm::radians(mouseXOffset);
+        auto yRadians = glm::radians(mouseYOffset);
+        return glm::rotate(Mat4Identity, yRadians, Vec3Unitx) * glm::rotate(Mat4Identity, xRadians, Vec3Unity) *
+               world;
+    }
+
+    CullCamera GetCullCamera(const glm::mat4 &sceneWorld) const
+    {
+        return CullCamera{vsConstantBuffer.view * sceneWorld, vsConstantBuffer.projection,
+                          glm::vec2(vsConstantBuffer.translation[0][3], vsConstantBuffer.translation[1][3])};
+    }
+
+    // 按模型的包围球设置远近裁剪面,鼠标旋转都绕原点进行,包围球半径不随旋转改变
+    void FitClipPlanes()
+    {
+        nearPlane = 0.1f;
+        farPlane = 100.0f;
+        const auto &asmBounds = bounds.GetBounds();
+        if (asmBounds.IsEmpty())
+        {
+            return;
+        }
+        Aabb worldBounds;
+        TransformBox(world, asmBounds.Min, asmBounds.Max, worldBounds);
+        float radius = glm::length(worldBounds.Max - worldBounds.Min) * 0.5f * 1.01f;
+        float distance = -(vsConstantBuffer.view * glm::vec4(Vec3Zero, 1.0f)).z;
+        nearPlane = glm::max(distance - radius, 0.01f);
+        farPlane = glm::max(distance + radius, nearPlane + 0.01f);
+    }
+
     void UpdateProjMatrix()
     {
         auto aspectRatio = static_cast<float>(width) / static_cast<float>(height);
         vsConstantBuffer.projection = glm::ortho(-orthoScale * aspectRatio, 
-        orthoScale * aspectRatio, -orthoScale, orthoScale, 0.1f, 100.0f);
+        orthoScale * aspectRatio, -orthoScale, orthoScale, nearPlane, farPlane);
     }
 
     void ProcessMouseScroll(float yoffset)
@@ -521,6 +1208,93 @@ void gl_control_update_geometry(AsmGeometry *asmgeo)
     glRender->UpdateGeometry(*asmGeometry);
 }
 
+int32_t gl_control_load_model(char *path)
+{
+    try
+    {
+        glRender->LoadModel(path);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Failed to load model: " << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+int32_t gl_control_snapshot(int32_t width, int32_t height, char *path)
+{
+    try
+    {
+        glRender->Snapshot(width, height, path);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Failed to save snapshot: " << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+void gl_control_set_component_states(const int32_t *ids, const ComponentState_t *states, int32_t n)
+{
+    glRender->SetComponentStates(ids, states, n);
+}
+
+static_assert(sizeof(ProtoRef_t) == sizeof(vgo::ProtoRef), "ProtoRef layout mismatch");
+
+const ProtoRef_t *gl_control_find_proto_face(int32_t protoId, int32_t *count)
+{
+    auto refs = glRender->GetProtoIndex().FindFace(protoId);
+    *count = static_cast<int32_t>(refs.size());
+    return reinterpret_cast<const ProtoRef_t *>(refs.data());
+}
+
+const ProtoRef_t *gl_control_find_proto_edge(int32_t protoId, int32_t *count)
+{
+    auto refs = glRender->GetProtoIndex().FindEdge(protoId);
+    *count = static_cast<int32_t>(refs.size());
+    return reinterpret_cast<const ProtoRef_t *>(refs.data());
+}
+
+const int32_t *gl_control_get_part_components(int32_t partIndex, int32_t *count)
+{
+    auto comps = glRender->GetProtoIndex().GetPartComponents(partIndex);
+    *count = static_cast<int32_t>(comps.size());
+    return comps.data();
+}
+
+int32_t gl_control_highlight_proto_face(int32_t protoId)
+{
+    return glRender->HighlightProtoFace(protoId);
+}
+
+int32_t gl_control_select_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t mode)
+{
+    return glRender->RectSelect(x0, y0, x1, y1,
+                                mode == SelectMode_Crossing ? vgo::SelectMode::Crossing : vgo::SelectMode::Inside);
+}
+
+const int32_t *gl_control_get_selection(int32_t *count)
+{
+    const auto &selection = glRender->GetSelection();
+    *count = static_cast<int32_t>(selection.size());
+    return selection.data();
+}
+
+int32_t gl_control_pending_parts()
+{
+    return glRender->GetPendingPartCount();
+}
+
+void gl_control_get_cull_stats(CullStats_t *stats)
+{
+    const auto &cullStats = glRender->GetCullStats();
+    stats->triangles = cullStats.Triangles;
+    stats->backfaceCulled = cullStats.BackfaceCulled;
+    stats->frustumCulled = cullStats.FrustumCulled;
+}
+
 void gl_control_mouse_down(KeyCode_t keycode, int32_t x, int32_t y)
 {
     glRender->MouseDown((vgo::KeyCode)keycode, x, y);
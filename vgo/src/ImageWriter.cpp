@@ -0,0 +1,222 @@
+#include "ImageWriter.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace vgo
+{
+
+namespace
+{
+void OpenOutput(std::ofstream &file, const std::filesystem::path &path)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to create image: " + path.string());
+    }
+}
+
+class PpmWriter : public ImageWriter
+{
+  public:
+    PpmWriter(const std::filesystem::path &path, int32_t width, int32_t height) : width(width)
+    {
+        OpenOutput(file, path);
+        file << "P6\n" << width << " " << height << "\n255\n";
+    }
+
+    void WriteRows(const uint8_t *rgb, int32_t rows) override
+    {
+        file.write(reinterpret_cast<const char *>(rgb), static_cast<std::streamsize>(width) * 3 * rows);
+    }
+
+    void Finish() override
+    {
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write image");
+        }
+    }
+
+  private:
+    std::ofstream file;
+    int32_t width;
+};
+
+// PNG的IDAT使用不压缩的deflate块,可以边渲染边写,不依赖zlib
+class PngWriter : public ImageWriter
+{
+  public:
+    PngWriter(const std::filesystem::path &path, int32_t width, int32_t height) : width(width)
+    {
+        OpenOutput(file, path);
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+        std::vector<uint8_t> header;
+        AppendU32(header, width);
+        AppendU32(header, height);
+        header.insert(header.end(), {8, 2, 0, 0, 0}); // 8位RGB,无隔行
+        WriteChunk("IHDR", header);
+        // zlib头: deflate,32K窗口,无预设字典
+        pending = {0x78, 0x01};
+    }
+
+    void WriteRows(const uint8_t *rgb, int32_t rows) override
+    {
+        auto stride = static_cast<size_t>(width) * 3;
+        for (int32_t r = 0; r < rows; r++)
+        {
+            static const uint8_t filterNone = 0;
+            AppendRaw(&filterNone, 1);
+            AppendRaw(rgb + stride * r, stride);
+        }
+        FlushBlocks(false);
+        WriteChunk("IDAT", pending);
+        pending.clear();
+    }
+
+    void Finish() override
+    {
+        FlushBlocks(true);
+        AppendU32(pending, (adlerB << 16) | adlerA);
+        WriteChunk("IDAT", pending);
+        pending.clear();
+        WriteChunk("IEND", pending);
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write image");
+        }
+    }
+
+  private:
+    static constexpr size_t MaxStoredBlock = 65535;
+
+    std::ofstream file;
+    int32_t width;
+    std::vector<uint8_t> raw;     // 还没有写成deflate块的数据
+    std::vector<uint8_t> pending; // 下一个IDAT的内容
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+
+    static const std::array<uint32_t, 256> &CrcTable()
+    {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; n++)
+            {
+                uint32_t c = n;
+                for (int32_t k = 0; k < 8; k++)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    static uint32_t Crc(uint32_t crc, const uint8_t *data, size_t size)
+    {
+        const auto &table = CrcTable();
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    static void AppendU32(std::vector<uint8_t> &out, uint32_t value)
+    {
+        out.insert(out.end(), {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                               static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)});
+    }
+
+    void AppendRaw(const uint8_t *data, size_t size)
+    {
+        // adler32,每5552字节取一次模就不会溢出
+        for (size_t i = 0; i < size;)
+        {
+            auto n = std::min<size_t>(size - i, 5552);
+            for (size_t k = 0; k < n; k++)
+            {
+                adlerA += data[i + k];
+                adlerB += adlerA;
+            }
+            adlerA %= 65521;
+            adlerB %= 65521;
+            i += n;
+        }
+        raw.insert(raw.end(), data, data + size);
+    }
+
+    // 把raw切成不压缩的deflate块,final为false时最后不足一块的数据留到下一次
+    void FlushBlocks(bool final)
+    {
+        size_t offset = 0;
+        while (raw.size() - offset >= MaxStoredBlock || (final && offset < raw.size()))
+        {
+            auto size = std::min(raw.size() - offset, MaxStoredBlock);
+            bool last = final && offset + size == raw.size();
+            AppendStoredBlock(raw.data() + offset, size, last);
+            offset += size;
+        }
+        if (final && raw.empty())
+        {
+            AppendStoredBlock(nullptr, 0, true);
+        }
+        raw.erase(raw.begin(), raw.begin() + offset);
+    }
+
+    void AppendStoredBlock(const uint8_t *data, size_t size, bool last)
+    {
+        auto len = static_cast<uint16_t>(size);
+        auto nlen = static_cast<uint16_t>(~len);
+        pending.insert(pending.end(), {static_cast<uint8_t>(last ? 1 : 0), static_cast<uint8_t>(len & 0xFF),
+                                       static_cast<uint8_t>(len >> 8), static_cast<uint8_t>(nlen & 0xFF),
+                                       static_cast<uint8_t>(nlen >> 8)});
+        pending.insert(pending.end(), data, data + size);
+    }
+
+    void WriteChunk(const char type[4], const std::vector<uint8_t> &data)
+    {
+        std::vector<uint8_t> head;
+        AppendU32(head, static_cast<uint32_t>(data.size()));
+        head.insert(head.end(), type, type + 4);
+        file.write(reinterpret_cast<const char *>(head.data()), head.size());
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+        auto crc = Crc(0xFFFFFFFFu, head.data() + 4, 4);
+        crc = Crc(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+        std::vector<uint8_t> tail;
+        AppendU32(tail, crc);
+        file.write(reinterpret_cast<const char *>(tail.data()), tail.size());
+    }
+};
+} // namespace
+
+std::unique_ptr<ImageWriter> CreateImageWriter(const std::filesystem::path &path, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::runtime_error("Invalid image size");
+    }
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    if (extension == ".png")
+    {
+        return std::make_unique<PngWriter>(path, width, height);
+    }
+    if (extension == ".ppm")
+    {
+        return std::make_unique<PpmWriter>(path, width, height);
+    }
+    throw std::runtime_error("Unsupported image format: " + extension);
+}
+} // namespace vgo
@@ -0,0 +1,284 @@
+#include "Meshlet.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace vgo
+{
+
+namespace
+{
+constexpr int32_t MeshletGrain = 64;
+constexpr int32_t CullGrain = 1024;
+// 三角形法线与当前meshlet平均法线的夹角超过约25度时开始新的meshlet,否则法线锥太宽无法剔除
+constexpr float MeshletNormalLimit = 0.9f;
+// 法线锥留一点余量,避免几乎侧对相机的三角形因为浮点误差被剔除
+constexpr float ConeEpsilon = 1e-3f;
+constexpr float NeverCull = 2.0f;
+
+enum class SphereClass
+{
+    Outside,
+    Intersect,
+    Inside,
+};
+
+glm::vec3 TriangleNormal(const PartGeometry &part, int32_t index)
+{
+    glm::vec3 p0 = part.Vertices[part.Indices[index]];
+    glm::vec3 p1 = part.Vertices[part.Indices[index + 1]];
+    glm::vec3 p2 = part.Vertices[part.Indices[index + 2]];
+    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+    float length = glm::length(n);
+    return length > FLT_MIN ? n / length : Vec3Zero;
+}
+
+Meshlet MakeMeshlet(const PartGeometry &part, int32_t begin, int32_t end)
+{
+    Meshlet meshlet;
+    meshlet.First = begin;
+    meshlet.Count = end - begin;
+
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    for (int32_t i = begin; i < end; i++)
+    {
+        glm::vec3 p = part.Vertices[part.Indices[i]];
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    meshlet.Center = (min + max) * 0.5f;
+    float radius2 = 0.0f;
+    for (int32_t i = begin; i < end; i++)
+    {
+        glm::vec3 d = glm::vec3(part.Vertices[part.Indices[i]]) - meshlet.Center;
+        radius2 = glm::max(radius2, glm::dot(d, d));
+    }
+    meshlet.Radius = std::sqrt(radius2);
+
+    glm::vec3 normalSum = Vec3Zero;
+    for (int32_t i = begin; i < end; i += 3)
+    {
+        normalSum += TriangleNormal(part, i);
+    }
+    float length = glm::length(normalSum);
+    meshlet.ConeAxis = length > FLT_MIN ? normalSum / length : Vec3Unitz;
+    meshlet.ConeCutoff = NeverCull;
+    if (length <= FLT_MIN)
+    {
+        return meshlet;
+    }
+    float minDot = 1.0f;
+    for (int32_t i = begin; i < end; i += 3)
+    {
+        auto n = TriangleNormal(part, i);
+        // 退化三角形不会被光栅化,不参与法线锥
+        if (glm::dot(n, n) > 0.0f)
+        {
+            minDot = glm::min(minDot, glm::dot(n, meshlet.ConeAxis));
+        }
+    }
+    if (minDot > 0.0f)
+    {
+        meshlet.ConeCutoff = std::sqrt(glm::max(1.0f - minDot * minDot, 0.0f)) + ConeEpsilon;
+    }
+    return meshlet;
+}
+
+// 正交投影下w恒为1,只需要x和y
+SphereClass ClassifySphere(const glm::mat4 &toNdc, const glm::vec2 &offset, const glm::vec3 &center, float radiusX,
+                           float radiusY)
+{
+    float x = toNdc[0][0] * center.x + toNdc[1][0] * center.y + toNdc[2][0] * center.z + toNdc[3][0] + offset.x;
+    float y = toNdc[0][1] * center.x + toNdc[1][1] * center.y + toNdc[2][1] * center.z + toNdc[3][1] + offset.y;
+    if (x - radiusX > 1.0f || x + radiusX < -1.0f || y - radiusY > 1.0f || y + radiusY < -1.0f)
+    {
+        return SphereClass::Outside;
+    }
+    if (std::abs(x) + radiusX <= 1.0f && std::abs(y) + radiusY <= 1.0f)
+    {
+        return SphereClass::Inside;
+    }
+    return SphereClass::Intersect;
+}
+
+void AppendRange(std::vector<DrawItem> &result, const DrawItem &item, int32_t first, int32_t count)
+{
+    if (!result.empty())
+    {
+        auto &last = result.back();
+        if (last.CompIndex == item.CompIndex && last.First + last.Count == first)
+        {
+            last.Count += count;
+            return;
+        }
+    }
+    result.push_back(DrawItem{item.CompIndex, item.PartIndex, first, count});
+}
+
+void CullItem(const AsmGeometry &asmGeometry, const std::vector<Meshlet> &meshlets, const CullCamera &camera,
+              const DrawItem &item, std::vector<DrawItem> &result, CullStats &stats)
+{
+    stats.Triangles += item.Count / 3;
+    const auto &part = asmGeometry.Parts[item.PartIndex];
+    glm::mat4 modelView = camera.View * asmGeometry.Components[item.CompIndex].CompMatrix;
+    glm::mat4 toNdc = camera.Proj * modelView;
+    // 局部长度到NDC长度的最大缩放
+    float scale = glm::max(glm::length(glm::vec3(modelView[0])),
+                           glm::max(glm::length(glm::vec3(modelView[1])), glm::length(glm::vec3(modelView[2]))));
+    float scaleX = scale * std::abs(camera.Proj[0][0]);
+    float scaleY = scale * std::abs(camera.Proj[1][1]);
+
+    glm::vec3 boxCenter = (part.Box[0] + part.Box[1]) * 0.5f;
+    float boxRadius = glm::length(part.Box[1] - part.Box[0]) * 0.5f;
+    auto compClass = ClassifySphere(toNdc, camera.Offset, boxCenter, boxRadius * scaleX, boxRadius * scaleY);
+    if (compClass == SphereClass::Outside)
+    {
+        stats.FrustumCulled += item.Count / 3;
+        return;
+    }
+    if (meshlets.empty())
+    {
+        AppendRange(result, item, item.First, item.Count);
+        return;
+    }
+
+    // 视线方向变换到局部坐标系: sign(det)*M^-1*(0,0,-1),镜像矩阵会翻转三角形的绕序
+    // 只用到M的前两行,结果与(b×c, c×a, a×b)的z分量成比例
+    glm::vec3 a = glm::vec3(modelView[0]);
+    glm::vec3 b = glm::vec3(modelView[1]);
+    glm::vec3 c = glm::vec3(modelView[2]);
+    glm::vec3 viewDir = -glm::vec3(b.x * c.y - b.y * c.x, c.x * a.y - c.y * a.x, a.x * b.y - a.y * b.x);
+    float viewLength = glm::length(viewDir);
+    bool backfaceTest = viewLength > FLT_MIN;
+    if (backfaceTest)
+    {
+        viewDir /= viewLength;
+    }
+
+    for (const auto &meshlet : meshlets)
+    {
+        if (backfaceTest && glm::dot(meshlet.ConeAxis, viewDir) > meshlet.ConeCutoff)
+        {
+            stats.BackfaceCulled += meshlet.Count / 3;
+            continue;
+        }
+        if (compClass == SphereClass::Intersect &&
+            ClassifySphere(toNdc, camera.Offset, meshlet.Center, meshlet.Radius * scaleX,
+                           meshlet.Radius * scaleY) == SphereClass::Outside)
+        {
+            stats.FrustumCulled += meshlet.Count / 3;
+            continue;
+        }
+        AppendRange(result, item, meshlet.First, meshlet.Count);
+    }
+}
+} // namespace
+
+void BuildMeshlets(const PartGeometry &part, std::vector<Meshlet> &meshlets)
+{
+    meshlets.clear();
+    auto begin = part.FaceStartIndex;
+    auto end = begin + part.FaceCount / 3 * 3;
+    if (part.FaceCount < 3 || part.Indices.size() < end || part.Vertices.size() == 0)
+    {
+        return;
+    }
+    // stamp记录顶点最后一次出现在哪个meshlet中,用来统计meshlet的顶点数
+    std::vector<int32_t> stamp(part.Vertices.size(), -1);
+    int32_t current = 0;
+    int32_t start = begin;
+    int32_t vertexCount = 0;
+    glm::vec3 normalSum = Vec3Zero;
+    for (int32_t i = begin; i < end; i += 3)
+    {
+        auto countNew = [&]() {
+            int32_t count = 0;
+            for (int32_t k = 0; k < 3; k++)
+            {
+                auto v = part.Indices[i + k];
+                bool repeated = (k > 0 && part.Indices[i] == v) || (k > 1 && part.Indices[i + 1] == v);
+                if (stamp[v] != current && !repeated)
+                {
+                    count++;
+                }
+            }
+            return count;
+        };
+        auto normal = TriangleNormal(part, i);
+        auto newVertices = countNew();
+        float sumLength = glm::length(normalSum);
+        bool split = (i - start) / 3 >= MeshletMaxTriangles || vertexCount + newVertices > MeshletMaxVertices ||
+                     (sumLength > FLT_MIN && glm::dot(normal, normalSum) < MeshletNormalLimit * sumLength &&
+                      glm::dot(normal, normal) > 0.0f);
+        if (split && i > start)
+        {
+            meshlets.push_back(MakeMeshlet(part, start, i));
+            current++;
+            start = i;
+            vertexCount = 0;
+            normalSum = Vec3Zero;
+            newVertices = countNew();
+        }
+        for (int32_t k = 0; k < 3; k++)
+        {
+            stamp[part.Indices[i + k]] = current;
+        }
+        vertexCount += newVertices;
+        normalSum += normal;
+    }
+    meshlets.push_back(MakeMeshlet(part, start, end));
+}
+
+void MeshletCache::Update(const AsmGeometry &asmGeometry)
+{
+    auto partsCount = asmGeometry.Parts.size();
+    partMeshlets.assign(partsCount, {});
+    ParallelFor(partsCount, MeshletGrain, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++)
+        {
+            BuildMeshlets(asmGeometry.Parts[i], partMeshlets[i]);
+        }
+    });
+}
+
+void MeshletCache::UpdatePart(int32_t partIndex, const PartGeometry &part)
+{
+    BuildMeshlets(part, partMeshlets[partIndex]);
+}
+
+CullStats MeshletCache::Cull(const AsmGeometry &asmGeometry, const CullCamera &camera,
+                             const std::vector<DrawItem> &items, std::vector<DrawItem> &result)
+{
+    // 每CullGrain个item的结果写到各自的列表,最后按顺序拼接,输出与串行一致
+    auto itemsCount = static_cast<int32_t>(items.size());
+    auto chunkCount = (itemsCount + CullGrain - 1) / CullGrain;
+    chunkItems.resize(chunkCount);
+    chunkStats.assign(chunkCount, CullStats());
+    ParallelFor(itemsCount, CullGrain, [&](int32_t begin, int32_t end) {
+        for (int32_t chunkBegin = begin; chunkBegin < end; chunkBegin += CullGrain)
+        {
+            auto chunk = chunkBegin / CullGrain;
+            auto &chunkResult = chunkItems[chunk];
+            chunkResult.clear();
+            for (int32_t i = chunkBegin; i < std::min(chunkBegin + CullGrain, end); i++)
+            {
+                const auto &item = items[i];
+                CullItem(asmGeometry, partMeshlets[item.PartIndex], camera, item, chunkResult, chunkStats[chunk]);
+            }
+        }
+    });
+
+    result.clear();
+    CullStats stats;
+    for (int32_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        result.insert(result.end(), chunkItems[chunk].begin(), chunkItems[chunk].end());
+        stats.Triangles += chunkStats[chunk].Triangles;
+        stats.BackfaceCulled += chunkStats[chunk].BackfaceCulled;
+        stats.FrustumCulled += chunkStats[chunk].FrustumCulled;
+    }
+    return stats;
+}
+} // namespace vgo
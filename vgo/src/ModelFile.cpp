@@ -0,0 +1,607 @@
+#include "ModelFile.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace vgo
+{
+
+namespace
+{
+constexpr uint64_t AlignUp(uint64_t value)
+{
+    return (value + ModelFileAlignment - 1) & ~(ModelFileAlignment - 1);
+}
+
+AlignedBytes AllocateAligned(uint64_t size)
+{
+    // 零长度的chunk也分配一块,用非空指针表示该part已经加载
+    auto ptr = ::operator new[](size == 0 ? ModelFileAlignment : size, std::align_val_t(ModelFileAlignment));
+    return AlignedBytes(static_cast<std::byte *>(ptr));
+}
+
+// chunk内每个数组相对chunk起点的偏移,顺序与ModelPartEntry::ArrayLengths一致
+struct ChunkLayout
+{
+    uint64_t Offsets[ModelPartArrayCount];
+    uint64_t Size;
+};
+
+constexpr uint64_t ArrayElementSizes[ModelPartArrayCount] = {sizeof(glm::vec4), sizeof(int32_t), sizeof(int32_t),
+                                                            sizeof(int32_t),   sizeof(int32_t), sizeof(int32_t)};
+
+ChunkLayout GetChunkLayout(const ModelPartEntry &entry)
+{
+    ChunkLayout layout{};
+    uint64_t offset = 0;
+    for (int32_t i = 0; i < ModelPartArrayCount; i++)
+    {
+        layout.Offsets[i] = offset;
+        offset = AlignUp(offset + ArrayElementSizes[i] * static_cast<uint64_t>(entry.ArrayLengths[i]));
+    }
+    layout.Size = offset;
+    return layout;
+}
+
+// LZ77字节流,序列格式与LZ4 block相同:
+// token(高4位字面量长度,低4位匹配长度-4) [扩展长度] 字面量 [offset(2字节) [扩展长度]]
+// 最后一个序列只有字面量
+constexpr uint64_t LzMinMatch = 4;
+constexpr uint64_t LzMaxOffset = 65535;
+constexpr int32_t LzHashBits = 14;
+
+uint32_t LzHash(const std::byte *p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return (value * 2654435761u) >> (32 - LzHashBits);
+}
+
+void LzWriteLength(std::vector<std::byte> &out, uint64_t length)
+{
+    while (length >= 255)
+    {
+        out.push_back(std::byte{255});
+        length -= 255;
+    }
+    out.push_back(static_cast<std::byte>(length));
+}
+
+void LzWriteSequence(std::vector<std::byte> &out, const std::byte *literals, uint64_t literalLength, uint64_t offset,
+                     uint64_t matchLength)
+{
+    uint64_t extraMatch = matchLength == 0 ? 0 : matchLength - LzMinMatch;
+    auto token = (std::min<uint64_t>(literalLength, 15) << 4) | std::min<uint64_t>(extraMatch, 15);
+    out.push_back(static_cast<std::byte>(token));
+    if (literalLength >= 15)
+    {
+        LzWriteLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+    if (matchLength == 0)
+    {
+        return;
+    }
+    out.push_back(static_cast<std::byte>(offset & 0xFF));
+    out.push_back(static_cast<std::byte>(offset >> 8));
+    if (extraMatch >= 15)
+    {
+        LzWriteLength(out, extraMatch - 15);
+    }
+}
+
+std::vector<std::byte> LzCompress(const std::byte *src, uint64_t size)
+{
+    std::vector<std::byte> out;
+    out.reserve(size / 2 + 16);
+    std::vector<int64_t> table(size_t(1) << LzHashBits, -1);
+    uint64_t anchor = 0;
+    uint64_t i = 0;
+    while (i + LzMinMatch <= size)
+    {
+        auto hash = LzHash(src + i);
+        auto candidate = table[hash];
+        table[hash] = static_cast<int64_t>(i);
+        if (candidate < 0 || i - candidate > LzMaxOffset || std::memcmp(src + candidate, src + i, LzMinMatch) != 0)
+        {
+            i++;
+            continue;
+        }
+        uint64_t length = LzMinMatch;
+        while (i + length < size && src[candidate + length] == src[i + length])
+        {
+            length++;
+        }
+        LzWriteSequence(out, src + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    LzWriteSequence(out, src + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+uint64_t LzReadLength(const std::byte *&ip, const std::byte *end)
+{
+    uint64_t length = 0;
+    while (true)
+    {
+        if (ip >= end)
+        {
+            throw std::runtime_error("Corrupted model chunk");
+        }
+        auto value = static_cast<uint8_t>(*ip++);
+        length += value;
+        if (value != 255)
+        {
+            return length;
+        }
+    }
+}
+
+constexpr uint64_t LzWildCopySlack = 16;
+
+// 按Step字节一组定长复制,最多多写Step-1个字节,调用方保证源和目标都有LzWildCopySlack的余量;
+// 目标在源之后Step字节以上时,重叠的匹配每组读取的也都是之前已经写好的数据
+template <uint64_t Step> void LzWildCopy(std::byte *dst, const std::byte *src, uint64_t length)
+{
+    for (uint64_t i = 0; i < length; i += Step)
+    {
+        std::memcpy(dst + i, src + i, Step);
+    }
+}
+
+void LzDecompress(const std::byte *src, uint64_t srcSize, std::byte *dst, uint64_t dstSize)
+{
+    const std::byte *ip = src;
+    const std::byte *end = src + srcSize;
+    uint64_t op = 0;
+    while (ip < end)
+    {
+        auto token = static_cast<uint8_t>(*ip++);
+        uint64_t literalLength = token >> 4;
+        // 最常见的短序列: 字面量不超过14字节,匹配不超过18字节且不重叠,
+        // 远离两端时固定复制16+16+16字节,不走下面逐项检查的分支
+        if (literalLength < 15 && (token & 0x0F) < 15 && end - ip >= 32 && dstSize - op >= 48)
+        {
+            std::memcpy(dst + op, ip, 16);
+            ip += literalLength;
+            op += literalLength;
+            uint64_t offset = static_cast<uint8_t>(ip[0]) | (static_cast<uint64_t>(static_cast<uint8_t>(ip[1])) << 8);
+            uint64_t matchLength = (token & 0x0F) + LzMinMatch;
+            if (offset >= LzWildCopySlack && offset <= op)
+            {
+                ip += 2;
+                std::memcpy(dst + op, dst + op - offset, 16);
+                std::memcpy(dst + op + 16, dst + op - offset + 16, 16);
+                op += matchLength;
+                continue;
+            }
+            // 匹配不满足条件时,字面量已经复制,回到通用路径处理匹配
+            ip -= literalLength;
+            op -= literalLength;
+        }
+        if (literalLength == 15)
+        {
+            literalLength += LzReadLength(ip, end);
+        }
+        if (literalLength > static_cast<uint64_t>(end - ip) || literalLength > dstSize - op)
+        {
+            throw std::runtime_error("Corrupted model chunk");
+        }
+        // 远离两端时用定长复制,避免对每段很短的字面量调用变长memcpy
+        if (literalLength + LzWildCopySlack <= static_cast<uint64_t>(end - ip) &&
+            literalLength + LzWildCopySlack <= dstSize - op)
+        {
+            LzWildCopy<LzWildCopySlack>(dst + op, ip, literalLength);
+        }
+        else
+        {
+            std::memcpy(dst + op, ip, literalLength);
+        }
+        ip += literalLength;
+        op += literalLength;
+        if (ip == end)
+        {
+            break;
+        }
+        if (end - ip < 2)
+        {
+            throw std::runtime_error("Corrupted model chunk");
+        }
+        uint64_t offset = static_cast<uint8_t>(ip[0]) | (static_cast<uint64_t>(static_cast<uint8_t>(ip[1])) << 8);
+        ip += 2;
+        uint64_t matchLength = token & 0x0F;
+        if (matchLength == 15)
+        {
+            matchLength += LzReadLength(ip, end);
+        }
+        matchLength += LzMinMatch;
+        if (offset == 0 || offset > op || matchLength > dstSize - op)
+        {
+            throw std::runtime_error("Corrupted model chunk");
+        }
+        if (offset >= 8 && matchLength + LzWildCopySlack <= dstSize - op)
+        {
+            // offset不小于每组的长度时,重叠的匹配也可以分组复制
+            if (offset >= LzWildCopySlack)
+            {
+                LzWildCopy<LzWildCopySlack>(dst + op, dst + op - offset, matchLength);
+            }
+            else
+            {
+                LzWildCopy<8>(dst + op, dst + op - offset, matchLength);
+            }
+            op += matchLength;
+            continue;
+        }
+        if (offset >= matchLength)
+        {
+            std::memcpy(dst + op, dst + op - offset, matchLength);
+            op += matchLength;
+            continue;
+        }
+        // 匹配区和输出重叠,只能逐字节复制
+        for (uint64_t i = 0; i < matchLength; i++, op++)
+        {
+            dst[op] = dst[op - offset];
+        }
+    }
+    if (op != dstSize)
+    {
+        throw std::runtime_error("Corrupted model chunk");
+    }
+}
+
+template <typename T> T ReadT(std::ifstream &file)
+{
+    T value{};
+    file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+}
+
+// 对应SourceSerializer的ReadArray,长度前缀是字节数
+template <typename T> std::vector<T> ReadArray(std::ifstream &file)
+{
+    auto byteLength = ReadT<int32_t>(file);
+    if (byteLength < 0 || byteLength % sizeof(T) != 0)
+    {
+        throw std::runtime_error("Corrupted mem file");
+    }
+    std::vector<T> result(byteLength / sizeof(T));
+    file.read(reinterpret_cast<char *>(result.data()), byteLength);
+    return result;
+}
+
+template <typename T> UnSafeArray<T> MakeArray(std::vector<T> &vec)
+{
+    return UnSafeArray<T>(vec.data(), static_cast<int32_t>(vec.size()));
+}
+
+template <typename T> UnSafeArray<T> MakeArray(std::byte *chunk, const ChunkLayout &layout, int32_t index, int32_t length)
+{
+    return UnSafeArray<T>(reinterpret_cast<T *>(chunk + layout.Offsets[index]), length);
+}
+
+template <typename T> void CopyArray(std::byte *chunk, const ChunkLayout &layout, int32_t index, const UnSafeArray<T> &src)
+{
+    if (src.size() > 0)
+    {
+        std::memcpy(chunk + layout.Offsets[index], src.data(), src.size() * sizeof(T));
+    }
+}
+
+// [offset, offset+size)是否在文件范围内,避免offset+size溢出
+bool InFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void WritePadding(std::ofstream &file, uint64_t offset)
+{
+    static const char zeros[ModelFileAlignment] = {};
+    auto pos = static_cast<uint64_t>(file.tellp());
+    while (pos < offset)
+    {
+        auto n = std::min<uint64_t>(offset - pos, ModelFileAlignment);
+        file.write(zeros, n);
+        pos += n;
+    }
+}
+} // namespace
+
+// 64位异或-乘法哈希,初值和乘数取自FNV-1a,但每次混入一个8字节的字而不是一个字节,
+// 所以结果与FNV-1a不同;尾部不足8字节的部分逐字节混入
+uint64_t HashBytes(const std::byte *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    for (; i < size; i++)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void WriteModelFile(const AsmGeometry &asmGeometry, const std::filesystem::path &path, bool compress)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to create model file: " + path.string());
+    }
+    ModelFileHeader header{};
+    header.Magic = ModelFileMagic;
+    header.Version = ModelFileVersion;
+    header.PartCount = asmGeometry.Parts.size();
+    header.CompCount = asmGeometry.Components.size();
+    header.PartTableOffset = AlignUp(sizeof(ModelFileHeader));
+    header.CompTableOffset = AlignUp(header.PartTableOffset + header.PartCount * sizeof(ModelPartEntry));
+    uint64_t offset = AlignUp(header.CompTableOffset + header.CompCount * sizeof(CompGeometry));
+
+    std::vector<ModelPartEntry> entries(header.PartCount);
+    for (int32_t i = 0; i < header.PartCount; i++)
+    {
+        const auto &part = asmGeometry.Parts[i];
+        auto &entry = entries[i];
+        entry.ArrayLengths[0] = part.Vertices.size();
+        entry.ArrayLengths[1] = part.Indices.size();
+        entry.ArrayLengths[2] = part.FaceIndices.size();
+        entry.ArrayLengths[3] = part.ProtoFaceIndices.size();
+        entry.ArrayLengths[4] = part.EdgeIndices.size();
+        entry.ArrayLengths[5] = part.ProtoEdgeIndices.size();
+        entry.FaceStartIndex = part.FaceStartIndex;
+        entry.FaceCount = part.FaceCount;
+        entry.EdgeStartIndex = part.EdgeStartIndex;
+        entry.EdgeCount = part.EdgeCount;
+        std::memcpy(entry.Box, part.Box, sizeof(entry.Box));
+
+        auto layout = GetChunkLayout(entry);
+        std::vector<std::byte> chunk(layout.Size);
+        CopyArray(chunk.data(), layout, 0, part.Vertices);
+        CopyArray(chunk.data(), layout, 1, part.Indices);
+        CopyArray(chunk.data(), layout, 2, part.FaceIndices);
+        CopyArray(chunk.data(), layout, 3, part.ProtoFaceIndices);
+        CopyArray(chunk.data(), layout, 4, part.EdgeIndices);
+        CopyArray(chunk.data(), layout, 5, part.ProtoEdgeIndices);
+        entry.RawSize = layout.Size;
+        entry.Hash = HashBytes(chunk.data(), chunk.size());
+        entry.Offset = offset;
+        entry.Compression = ChunkCompression::None;
+
+        // 压缩收益不到1/8时保留原始数据,这样仍然可以直接映射
+        std::vector<std::byte> compressed;
+        if (compress)
+        {
+            compressed = LzCompress(chunk.data(), chunk.size());
+        }
+        WritePadding(file, offset);
+        if (compress && compressed.size() < chunk.size() - chunk.size() / 8)
+        {
+            entry.Compression = ChunkCompression::Lz;
+            entry.StoredSize = compressed.size();
+            file.write(reinterpret_cast<const char *>(compressed.data()), compressed.size());
+        }
+        else
+        {
+            entry.StoredSize = chunk.size();
+            file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+        }
+        offset = AlignUp(offset + entry.StoredSize);
+    }
+    header.FileSize = static_cast<uint64_t>(file.tellp());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    WritePadding(file, header.PartTableOffset);
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(ModelPartEntry));
+    WritePadding(file, header.CompTableOffset);
+    file.write(reinterpret_cast<const char *>(asmGeometry.Components.data()),
+               header.CompCount * sizeof(CompGeometry));
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write model file: " + path.string());
+    }
+}
+
+MemModel::MemModel(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open mem file: " + path.string());
+    }
+    auto partCount = ReadT<int32_t>(file);
+    if (partCount < 0)
+    {
+        throw std::runtime_error("Corrupted mem file");
+    }
+    arrays.resize(partCount);
+    parts.resize(partCount);
+    for (int32_t i = 0; i < partCount; i++)
+    {
+        auto &a = arrays[i];
+        auto &part = parts[i];
+        a.Vertices = ReadArray<glm::vec4>(file);
+        ReadT<int32_t>(file); // VertexArrayLength
+        a.Indices = ReadArray<int32_t>(file);
+        ReadT<int32_t>(file); // FaceStartIndex,永远是0
+        auto faceIndexLength = ReadT<int32_t>(file);
+        ReadT<int32_t>(file); // EdgeStartIndex
+        ReadT<int32_t>(file); // EdgeIndexLength
+        a.FaceIndices = ReadArray<int32_t>(file);
+        a.ProtoFaceIndices = ReadArray<int32_t>(file);
+        a.EdgeIndices = ReadArray<int32_t>(file);
+        a.ProtoEdgeIndices = ReadArray<int32_t>(file);
+        auto box = ReadArray<glm::vec3>(file);
+        if (box.size() != 2)
+        {
+            throw std::runtime_error("Corrupted mem file");
+        }
+
+        // 与Viewer.IContract.PartGeometry的构造保持一致
+        part.Vertices = MakeArray(a.Vertices);
+        part.Indices = MakeArray(a.Indices);
+        part.FaceIndices = MakeArray(a.FaceIndices);
+        part.ProtoFaceIndices = MakeArray(a.ProtoFaceIndices);
+        part.EdgeIndices = MakeArray(a.EdgeIndices);
+        part.ProtoEdgeIndices = MakeArray(a.ProtoEdgeIndices);
+        part.FaceStartIndex = 0;
+        part.FaceCount = faceIndexLength;
+        part.EdgeStartIndex = faceIndexLength;
+        part.EdgeCount = part.Indices.size() - faceIndexLength;
+        part.Box[0] = box[0];
+        part.Box[1] = box[1];
+    }
+
+    auto compCount = ReadT<int32_t>(file);
+    if (compCount < 0)
+    {
+        throw std::runtime_error("Corrupted mem file");
+    }
+    comps.resize(compCount);
+    for (auto &comp : comps)
+    {
+        comp.PartIndex = ReadT<int32_t>(file);
+        comp.CompMatrix = ReadT<glm::mat4>(file);
+        if (comp.PartIndex < 0 || comp.PartIndex >= partCount)
+        {
+            throw std::runtime_error("Corrupted mem file");
+        }
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Unexpected end of mem file: " + path.string());
+    }
+    geometry.Parts = MakeArray(parts);
+    geometry.Components = MakeArray(comps);
+}
+
+ModelFile::ModelFile(const std::filesystem::path &path) : file(path, std::ios::binary), header()
+{
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open model file: " + path.string());
+    }
+    Read(0, &header, sizeof(header));
+    if (header.Magic != ModelFileMagic || header.Version != ModelFileVersion || header.PartCount < 0 ||
+        header.CompCount < 0)
+    {
+        throw std::runtime_error("Unsupported model file: " + path.string());
+    }
+    // 先按文件大小检查两张表的范围再分配,损坏或截断的文件不会因为过大的数量分配内存
+    if (header.FileSize > std::filesystem::file_size(path) ||
+        !InFile(header.PartTableOffset, static_cast<uint64_t>(header.PartCount) * sizeof(ModelPartEntry),
+                header.FileSize) ||
+        !InFile(header.CompTableOffset, static_cast<uint64_t>(header.CompCount) * sizeof(CompGeometry),
+                header.FileSize))
+    {
+        throw std::runtime_error("Corrupted model file: " + path.string());
+    }
+    entries.resize(header.PartCount);
+    Read(header.PartTableOffset, entries.data(), entries.size() * sizeof(ModelPartEntry));
+    comps.resize(header.CompCount);
+    Read(header.CompTableOffset, comps.data(), comps.size() * sizeof(CompGeometry));
+    for (const auto &comp : comps)
+    {
+        if (comp.PartIndex < 0 || comp.PartIndex >= header.PartCount)
+        {
+            throw std::runtime_error("Corrupted model file: " + path.string());
+        }
+    }
+    // 打开时就校验part表,避免延迟加载时才读到越界的chunk
+    for (const auto &entry : entries)
+    {
+        if (!InFile(entry.Offset, entry.StoredSize, header.FileSize) ||
+            std::any_of(std::begin(entry.ArrayLengths), std::end(entry.ArrayLengths),
+                        [](int32_t length) { return length < 0; }))
+        {
+            throw std::runtime_error("Corrupted model file: " + path.string());
+        }
+    }
+
+    parts.resize(header.PartCount);
+    chunks.resize(header.PartCount);
+    for (int32_t i = 0; i < header.PartCount; i++)
+    {
+        const auto &entry = entries[i];
+        auto &part = parts[i];
+        part = PartGeometry{};
+        part.Box[0] = glm::vec3(entry.Box[0], entry.Box[1], entry.Box[2]);
+        part.Box[1] = glm::vec3(entry.Box[3], entry.Box[4], entry.Box[5]);
+    }
+    geometry.Parts = MakeArray(parts);
+    geometry.Components = MakeArray(comps);
+}
+
+const PartGeometry &ModelFile::LoadPart(int32_t partIndex)
+{
+    auto &part = parts[partIndex];
+    if (IsPartLoaded(partIndex))
+    {
+        return part;
+    }
+    const auto &entry = entries[partIndex];
+    auto layout = GetChunkLayout(entry);
+    if (layout.Size != entry.RawSize)
+    {
+        throw std::runtime_error("Corrupted model part: " + std::to_string(partIndex));
+    }
+    auto chunk = AllocateAligned(entry.RawSize);
+    switch (entry.Compression)
+    {
+    case ChunkCompression::None:
+        if (entry.StoredSize != entry.RawSize)
+        {
+            throw std::runtime_error("Corrupted model part: " + std::to_string(partIndex));
+        }
+        Read(entry.Offset, chunk.get(), entry.RawSize);
+        break;
+    case ChunkCompression::Lz: {
+        std::vector<std::byte> stored(entry.StoredSize);
+        Read(entry.Offset, stored.data(), stored.size());
+        LzDecompress(stored.data(), stored.size(), chunk.get(), entry.RawSize);
+        break;
+    }
+    default:
+        throw std::runtime_error("Unsupported chunk compression: " + std::to_string(partIndex));
+    }
+    if (HashBytes(chunk.get(), entry.RawSize) != entry.Hash)
+    {
+        throw std::runtime_error("Model part hash mismatch: " + std::to_string(partIndex));
+    }
+
+    part.Vertices = MakeArray<glm::vec4>(chunk.get(), layout, 0, entry.ArrayLengths[0]);
+    part.Indices = MakeArray<int32_t>(chunk.get(), layout, 1, entry.ArrayLengths[1]);
+    part.FaceIndices = MakeArray<int32_t>(chunk.get(), layout, 2, entry.ArrayLengths[2]);
+    part.ProtoFaceIndices = MakeArray<int32_t>(chunk.get(), layout, 3, entry.ArrayLengths[3]);
+    part.EdgeIndices = MakeArray<int32_t>(chunk.get(), layout, 4, entry.ArrayLengths[4]);
+    part.ProtoEdgeIndices = MakeArray<int32_t>(chunk.get(), layout, 5, entry.ArrayLengths[5]);
+    part.FaceStartIndex = entry.FaceStartIndex;
+    part.FaceCount = entry.FaceCount;
+    part.EdgeStartIndex = entry.EdgeStartIndex;
+    part.EdgeCount = entry.EdgeCount;
+    chunks[partIndex] = std::move(chunk);
+    return part;
+}
+
+void ModelFile::Read(uint64_t offset, void *dst, uint64_t size)
+{
+    // 上一次读取失败会留下failbit,不清除的话之后的seekg/read都会失败
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(static_cast<char *>(dst), static_cast<std::streamsize>(size));
+    if (!file)
+    {
+        throw std::runtime_error("Unexpected end of model file");
+    }
+}
+} // namespace vgo
@@ -0,0 +1,145 @@
+#include "Parallel.h"
+#include <utility>
+
+namespace vgo
+{
+
+namespace
+{
+// 任务中嵌套的ParallelFor直接串行执行,避免等待自己
+thread_local bool insideTask = false;
+
+// 任务抛出异常时也要恢复insideTask,否则之后这个线程上的ParallelFor都会串行执行
+struct TaskScope
+{
+    bool previous;
+
+    TaskScope() : previous(insideTask)
+    {
+        insideTask = true;
+    }
+
+    ~TaskScope()
+    {
+        insideTask = previous;
+    }
+};
+} // namespace
+
+WorkerPool &WorkerPool::Get()
+{
+    // 故意不释放: 在DLL卸载或进程退出时join线程可能死锁,线程随进程一起结束
+    static WorkerPool *pool = new WorkerPool();
+    return *pool;
+}
+
+WorkerPool::WorkerPool()
+{
+    int32_t hardware = std::max<int32_t>(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    threads.reserve(hardware - 1);
+    for (int32_t i = 1; i < hardware; i++)
+    {
+        threads.emplace_back([this]() { WorkerLoop(); });
+        threads.back().detach();
+    }
+}
+
+void WorkerPool::Run(int32_t count, const std::function<void(int32_t)> &current)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (insideTask || threads.empty() || count == 1)
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            current(i);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> runLock(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &current;
+        taskCount = count;
+        nextTask = 0;
+        error = nullptr;
+        generation++;
+    }
+    wake.notify_all();
+    {
+        TaskScope scope;
+        RunTasks(current, count);
+    }
+
+    // 领取过任务的线程全部退出之后才能清除task,之后醒来的线程看到task为空直接继续等待
+    std::exception_ptr failed;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return activeWorkers == 0; });
+        task = nullptr;
+        failed = std::exchange(error, nullptr);
+    }
+    if (failed)
+    {
+        std::rethrow_exception(failed);
+    }
+}
+
+void WorkerPool::RunTasks(const std::function<void(int32_t)> &current, int32_t count)
+{
+    while (true)
+    {
+        int32_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            index = nextTask < count ? nextTask++ : count;
+        }
+        if (index >= count)
+        {
+            return;
+        }
+        try
+        {
+            current(index);
+        }
+        catch (...)
+        {
+            // 只保留第一个异常,剩下的任务不再分发,由Run在所有线程退出后重新抛出
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            nextTask = count;
+        }
+    }
+}
+
+void WorkerPool::WorkerLoop()
+{
+    insideTask = true;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [&]() { return generation != seen; });
+        seen = generation;
+        if (task == nullptr)
+        {
+            continue;
+        }
+        auto current = task;
+        auto count = taskCount;
+        activeWorkers++;
+        lock.unlock();
+        RunTasks(*current, count);
+        lock.lock();
+        if (--activeWorkers == 0)
+        {
+            done.notify_all();
+        }
+    }
+}
+} // namespace vgo
@@ -0,0 +1,121 @@
+#include "ProtoIndex.h"
+#include <algorithm>
+
+namespace vgo
+{
+
+namespace
+{
+enum class Primitive
+{
+    Face,
+    Edge,
+};
+
+// 键的高32位是原型id(翻转符号位,使无符号比较与有符号一致),低32位是图元按(part,图元id)排列的序号,
+// 排序之后同一原型的图元仍然按part和图元id升序,相邻的图元可以合并成区间
+template <typename Table> void BuildTable(const AsmGeometry &asmGeometry, Primitive primitive, Table &table)
+{
+    std::vector<uint64_t> keys;
+    std::vector<ProtoRef> prims;
+    auto partsCount = asmGeometry.Parts.size();
+    for (int32_t p = 0; p < partsCount; p++)
+    {
+        const auto &part = asmGeometry.Parts[p];
+        const auto &protos = primitive == Primitive::Face ? part.ProtoFaceIndices : part.ProtoEdgeIndices;
+        auto base = primitive == Primitive::Face ? 0 : std::max<int32_t>(part.FaceIndices.size() - 1, 0);
+        auto count = protos.size();
+        for (int32_t i = 0; i < count; i++)
+        {
+            auto protoId = static_cast<uint32_t>(protos[i]) ^ 0x80000000u;
+            keys.push_back((static_cast<uint64_t>(protoId) << 32) | static_cast<uint32_t>(prims.size()));
+            prims.push_back(ProtoRef{p, base + i, base + i + 1});
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+
+    table.Keys.clear();
+    table.Offsets.clear();
+    table.Refs.clear();
+    for (auto key : keys)
+    {
+        auto protoId = static_cast<int32_t>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+        const auto &prim = prims[static_cast<uint32_t>(key)];
+        if (table.Keys.empty() || table.Keys.back() != protoId)
+        {
+            table.Keys.push_back(protoId);
+            table.Offsets.push_back(static_cast<int32_t>(table.Refs.size()));
+        }
+        else
+        {
+            auto &last = table.Refs.back();
+            if (last.PartIndex == prim.PartIndex && last.End == prim.Begin)
+            {
+                last.End = prim.End;
+                continue;
+            }
+        }
+        table.Refs.push_back(prim);
+    }
+    table.Offsets.push_back(static_cast<int32_t>(table.Refs.size()));
+}
+} // namespace
+
+void ProtoIndex::Update(const AsmGeometry &asmGeometry)
+{
+    // part -> 组件,计数排序
+    auto partsCount = asmGeometry.Parts.size();
+    auto compsCount = asmGeometry.Components.size();
+    partOffsets.assign(partsCount + 1, 0);
+    for (int32_t i = 0; i < compsCount; i++)
+    {
+        auto partIndex = asmGeometry.Components[i].PartIndex;
+        if (partIndex >= 0 && partIndex < partsCount)
+        {
+            partOffsets[partIndex + 1]++;
+        }
+    }
+    for (int32_t p = 0; p < partsCount; p++)
+    {
+        partOffsets[p + 1] += partOffsets[p];
+    }
+    partComps.resize(partOffsets[partsCount]);
+    std::vector<int32_t> cursor(partOffsets.begin(), partOffsets.end() - 1);
+    for (int32_t i = 0; i < compsCount; i++)
+    {
+        auto partIndex = asmGeometry.Components[i].PartIndex;
+        if (partIndex >= 0 && partIndex < partsCount)
+        {
+            partComps[cursor[partIndex]++] = i;
+        }
+    }
+    UpdatePrimitives(asmGeometry);
+}
+
+void ProtoIndex::UpdatePrimitives(const AsmGeometry &asmGeometry)
+{
+    BuildTable(asmGeometry, Primitive::Face, faces);
+    BuildTable(asmGeometry, Primitive::Edge, edges);
+}
+
+std::span<const int32_t> ProtoIndex::GetPartComponents(int32_t partIndex) const
+{
+    if (partIndex < 0 || partIndex + 1 >= static_cast<int32_t>(partOffsets.size()))
+    {
+        return {};
+    }
+    return std::span<const int32_t>(partComps.data() + partOffsets[partIndex],
+                                    partOffsets[partIndex + 1] - partOffsets[partIndex]);
+}
+
+std::span<const ProtoRef> ProtoIndex::Table::Find(int32_t protoId) const
+{
+    auto it = std::lower_bound(Keys.begin(), Keys.end(), protoId);
+    if (it == Keys.end() || *it != protoId)
+    {
+        return {};
+    }
+    auto slot = it - Keys.begin();
+    return std::span<const ProtoRef>(Refs.data() + Offsets[slot], Offsets[slot + 1] - Offsets[slot]);
+}
+} // namespace vgo
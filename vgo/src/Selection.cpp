@@ -0,0 +1,288 @@
+#include "Selection.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef VGO_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vgo
+{
+
+namespace
+{
+// 必须是4的倍数,每个分块的起点都按4对齐
+constexpr int32_t SelectGrain = 4096;
+
+// NDC的x和y分别是点的线性函数 dot(Axis,p)+Offset
+struct NdcAxis
+{
+    glm::vec3 Axis;
+    float Offset;
+};
+
+NdcAxis GetNdcAxis(const glm::mat4 &toNdc, int32_t row, float offset)
+{
+    return NdcAxis{glm::vec3(toNdc[0][row], toNdc[1][row], toNdc[2][row]), toNdc[3][row] + offset};
+}
+
+glm::vec2 ToNdc(const glm::mat4 &toNdc, const glm::vec2 &offset, const glm::vec4 &vertex)
+{
+    return glm::vec2(toNdc[0][0] * vertex.x + toNdc[1][0] * vertex.y + toNdc[2][0] * vertex.z + toNdc[3][0],
+                     toNdc[0][1] * vertex.x + toNdc[1][1] * vertex.y + toNdc[2][1] * vertex.z + toNdc[3][1]) +
+           offset;
+}
+
+bool InRect(const SelectRect &rect, const glm::vec2 &p)
+{
+    return p.x >= rect.Min.x && p.x <= rect.Max.x && p.y >= rect.Min.y && p.y <= rect.Max.y;
+}
+
+// 二维分离轴测试: 矩形的两个轴和三角形的三条边法线
+bool TriangleOverlapsRect(const SelectRect &rect, const glm::vec2 &p0, const glm::vec2 &p1, const glm::vec2 &p2)
+{
+    if (glm::max(p0.x, glm::max(p1.x, p2.x)) < rect.Min.x || glm::min(p0.x, glm::min(p1.x, p2.x)) > rect.Max.x ||
+        glm::max(p0.y, glm::max(p1.y, p2.y)) < rect.Min.y || glm::min(p0.y, glm::min(p1.y, p2.y)) > rect.Max.y)
+    {
+        return false;
+    }
+    glm::vec2 center = (rect.Min + rect.Max) * 0.5f;
+    glm::vec2 half = (rect.Max - rect.Min) * 0.5f;
+    const glm::vec2 points[3] = {p0, p1, p2};
+    for (int32_t i = 0; i < 3; i++)
+    {
+        glm::vec2 edge = points[(i + 1) % 3] - points[i];
+        glm::vec2 normal(-edge.y, edge.x);
+        float a = glm::dot(normal, points[i]);
+        float b = glm::dot(normal, points[(i + 2) % 3]);
+        float c = glm::dot(normal, center);
+        float r = std::abs(normal.x) * half.x + std::abs(normal.y) * half.y;
+        if (c + r < glm::min(a, b) || c - r > glm::max(a, b))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RefineRange(const PartGeometry &part, const glm::mat4 &toNdc, const glm::vec2 &offset, const SelectRect &rect,
+                 SelectMode mode, int32_t begin, int32_t end)
+{
+    if (mode == SelectMode::Inside)
+    {
+        for (int32_t i = begin; i < end; i++)
+        {
+            if (!InRect(rect, ToNdc(toNdc, offset, part.Vertices[part.Indices[i]])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (int32_t i = begin; i < end; i += 3)
+    {
+        if (TriangleOverlapsRect(rect, ToNdc(toNdc, offset, part.Vertices[part.Indices[i]]),
+                                 ToNdc(toNdc, offset, part.Vertices[part.Indices[i + 1]]),
+                                 ToNdc(toNdc, offset, part.Vertices[part.Indices[i + 2]])))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 包围盒与矩形边界相交的组件,用part的面精确判断,未加载的part只能按包围盒处理
+// 有meshlet时先用meshlet的包围球排除或确认整段三角形
+bool Refine(const AsmGeometry &asmGeometry, const MeshletCache *meshlets, const CullCamera &camera,
+            const SelectRect &rect, SelectMode mode, int32_t compIndex)
+{
+    const auto &comp = asmGeometry.Components[compIndex];
+    const auto &part = asmGeometry.Parts[comp.PartIndex];
+    auto begin = part.FaceStartIndex;
+    auto end = begin + part.FaceCount / 3 * 3;
+    if (part.FaceCount < 3 || part.Indices.size() < end || part.Vertices.size() == 0)
+    {
+        return mode == SelectMode::Crossing;
+    }
+    glm::mat4 modelView = camera.View * comp.CompMatrix;
+    glm::mat4 toNdc = camera.Proj * modelView;
+    if (meshlets == nullptr || meshlets->GetMeshlets(comp.PartIndex).empty())
+    {
+        return RefineRange(part, toNdc, camera.Offset, rect, mode, begin, end);
+    }
+    float scale = glm::max(glm::length(glm::vec3(modelView[0])),
+                           glm::max(glm::length(glm::vec3(modelView[1])), glm::length(glm::vec3(modelView[2]))));
+    float scaleX = scale * std::abs(camera.Proj[0][0]);
+    float scaleY = scale * std::abs(camera.Proj[1][1]);
+    for (const auto &meshlet : meshlets->GetMeshlets(comp.PartIndex))
+    {
+        auto center = ToNdc(toNdc, camera.Offset, glm::vec4(meshlet.Center, 1.0f));
+        float rx = meshlet.Radius * scaleX;
+        float ry = meshlet.Radius * scaleY;
+        bool outside = center.x + rx < rect.Min.x || center.x - rx > rect.Max.x || center.y + ry < rect.Min.y ||
+                       center.y - ry > rect.Max.y;
+        bool inside = center.x - rx >= rect.Min.x && center.x + rx <= rect.Max.x && center.y - ry >= rect.Min.y &&
+                      center.y + ry <= rect.Max.y;
+        if (mode == SelectMode::Inside)
+        {
+            if (outside || (!inside && !RefineRange(part, toNdc, camera.Offset, rect, mode, meshlet.First,
+                                                    meshlet.First + meshlet.Count)))
+            {
+                return false;
+            }
+        }
+        else if (inside || (!outside && RefineRange(part, toNdc, camera.Offset, rect, mode, meshlet.First,
+                                                    meshlet.First + meshlet.Count)))
+        {
+            return true;
+        }
+    }
+    return mode == SelectMode::Inside;
+}
+} // namespace
+
+SelectRect ScreenToNdcRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t width, int32_t height)
+{
+    auto toNdcX = [width](int32_t x) { return 2.0f * static_cast<float>(x) / static_cast<float>(width) - 1.0f; };
+    auto toNdcY = [height](int32_t y) { return 1.0f - 2.0f * static_cast<float>(y) / static_cast<float>(height); };
+    return SelectRect{glm::vec2(glm::min(toNdcX(x0), toNdcX(x1)), glm::min(toNdcY(y0), toNdcY(y1))),
+                      glm::vec2(glm::max(toNdcX(x0), toNdcX(x1)), glm::max(toNdcY(y0), toNdcY(y1)))};
+}
+
+void RectSelector::Update(const std::vector<Aabb> &compBounds)
+{
+    count = static_cast<int32_t>(compBounds.size());
+    // 补齐到4的倍数,补齐部分的半长为负,总是在矩形外
+    auto padded = (count + 3) / 4 * 4;
+    for (auto *values : {&centerX, &centerY, &centerZ})
+    {
+        values->assign(padded, 0.0f);
+    }
+    for (auto *values : {&extentX, &extentY, &extentZ})
+    {
+        values->assign(padded, -1.0f);
+    }
+    for (int32_t i = 0; i < count; i++)
+    {
+        const auto &box = compBounds[i];
+        if (box.IsEmpty())
+        {
+            continue;
+        }
+        auto center = (box.Min + box.Max) * 0.5f;
+        auto extent = (box.Max - box.Min) * 0.5f;
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        extentX[i] = extent.x;
+        extentY[i] = extent.y;
+        extentZ[i] = extent.z;
+    }
+}
+
+void RectSelector::Select(const AsmGeometry &asmGeometry, const CullCamera &camera, const SelectRect &rect,
+                          SelectMode mode, std::vector<int32_t> &result, const MeshletCache *meshlets)
+{
+    result.clear();
+    if (count == 0 || count != asmGeometry.Components.size())
+    {
+        return;
+    }
+    // 包围盒中心投影到NDC,半长投影到NDC的半径是|Axis|·extent
+    glm::mat4 toNdc = camera.Proj * camera.View;
+    auto ndcX = GetNdcAxis(toNdc, 0, camera.Offset.x);
+    auto ndcY = GetNdcAxis(toNdc, 1, camera.Offset.y);
+    auto chunkCount = (count + SelectGrain - 1) / SelectGrain;
+    chunkComps.resize(chunkCount);
+
+    ParallelFor(count, SelectGrain, [&](int32_t begin, int32_t end) {
+        for (int32_t chunkBegin = begin; chunkBegin < end; chunkBegin += SelectGrain)
+        {
+            auto &comps = chunkComps[chunkBegin / SelectGrain];
+            comps.clear();
+            auto chunkEnd = std::min(chunkBegin + SelectGrain, end);
+            auto accept = [&](int32_t i, bool inside) {
+                if (inside || Refine(asmGeometry, meshlets, camera, rect, mode, i))
+                {
+                    comps.push_back(i);
+                }
+            };
+#ifdef VGO_SSE2
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 ax0 = _mm_set1_ps(ndcX.Axis.x), ax1 = _mm_set1_ps(ndcX.Axis.y), ax2 = _mm_set1_ps(ndcX.Axis.z);
+            const __m128 ay0 = _mm_set1_ps(ndcY.Axis.x), ay1 = _mm_set1_ps(ndcY.Axis.y), ay2 = _mm_set1_ps(ndcY.Axis.z);
+            const __m128 bx = _mm_set1_ps(ndcX.Offset), by = _mm_set1_ps(ndcY.Offset);
+            const __m128 minX = _mm_set1_ps(rect.Min.x), maxX = _mm_set1_ps(rect.Max.x);
+            const __m128 minY = _mm_set1_ps(rect.Min.y), maxY = _mm_set1_ps(rect.Max.y);
+            for (int32_t i = chunkBegin; i < chunkEnd; i += 4)
+            {
+                __m128 cx = _mm_loadu_ps(&centerX[i]);
+                __m128 cy = _mm_loadu_ps(&centerY[i]);
+                __m128 cz = _mm_loadu_ps(&centerZ[i]);
+                __m128 ex = _mm_loadu_ps(&extentX[i]);
+                __m128 ey = _mm_loadu_ps(&extentY[i]);
+                __m128 ez = _mm_loadu_ps(&extentZ[i]);
+                __m128 fx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax0, cx), _mm_mul_ps(ax1, cy)),
+                                       _mm_add_ps(_mm_mul_ps(ax2, cz), bx));
+                __m128 fy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ay0, cx), _mm_mul_ps(ay1, cy)),
+                                       _mm_add_ps(_mm_mul_ps(ay2, cz), by));
+                __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(ax0, absMask), ex),
+                                                  _mm_mul_ps(_mm_and_ps(ax1, absMask), ey)),
+                                       _mm_mul_ps(_mm_and_ps(ax2, absMask), ez));
+                __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(ay0, absMask), ex),
+                                                  _mm_mul_ps(_mm_and_ps(ay1, absMask), ey)),
+                                       _mm_mul_ps(_mm_and_ps(ay2, absMask), ez));
+                __m128 outside = _mm_or_ps(
+                    _mm_or_ps(_mm_cmplt_ps(_mm_add_ps(fx, rx), minX), _mm_cmpgt_ps(_mm_sub_ps(fx, rx), maxX)),
+                    _mm_or_ps(_mm_cmplt_ps(_mm_add_ps(fy, ry), minY), _mm_cmpgt_ps(_mm_sub_ps(fy, ry), maxY)));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(ex, _mm_setzero_ps()));
+                __m128 inside = _mm_and_ps(
+                    _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(fx, rx), minX), _mm_cmple_ps(_mm_add_ps(fx, rx), maxX)),
+                    _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(fy, ry), minY), _mm_cmple_ps(_mm_add_ps(fy, ry), maxY)));
+                auto outsideMask = _mm_movemask_ps(outside);
+                if (outsideMask == 0xF)
+                {
+                    continue;
+                }
+                auto insideMask = _mm_movemask_ps(inside);
+                for (int32_t k = 0; k < 4 && i + k < chunkEnd; k++)
+                {
+                    if ((outsideMask & (1 << k)) == 0)
+                    {
+                        accept(i + k, (insideMask & (1 << k)) != 0);
+                    }
+                }
+            }
+#else
+            auto absX = glm::abs(ndcX.Axis);
+            auto absY = glm::abs(ndcY.Axis);
+            for (int32_t i = chunkBegin; i < chunkEnd; i++)
+            {
+                if (extentX[i] < 0.0f)
+                {
+                    continue;
+                }
+                glm::vec3 center(centerX[i], centerY[i], centerZ[i]);
+                glm::vec3 extent(extentX[i], extentY[i], extentZ[i]);
+                float fx = glm::dot(ndcX.Axis, center) + ndcX.Offset;
+                float fy = glm::dot(ndcY.Axis, center) + ndcY.Offset;
+                float rx = glm::dot(absX, extent);
+                float ry = glm::dot(absY, extent);
+                if (fx + rx < rect.Min.x || fx - rx > rect.Max.x || fy + ry < rect.Min.y || fy - ry > rect.Max.y)
+                {
+                    continue;
+                }
+                accept(i, fx - rx >= rect.Min.x && fx + rx <= rect.Max.x && fy - ry >= rect.Min.y &&
+                              fy + ry <= rect.Max.y);
+            }
+#endif
+        }
+    });
+
+    for (int32_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        result.insert(result.end(), chunkComps[chunk].begin(), chunkComps[chunk].end());
+    }
+}
+} // namespace vgo
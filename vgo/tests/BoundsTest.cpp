@@ -0,0 +1,133 @@
+#include "Bounds.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/ext/matrix_transform.hpp>
+#include <random>
+
+// TransformBox/BoundsCache与逐个变换8个角点的结果对比,覆盖旋转,非均匀缩放和镜像矩阵,
+// 并检查BoundsMode::Vertices的结果都在BoundsMode::Box之内
+// 用法: vgo_test_bounds,全部通过返回0
+namespace
+{
+using vgo::test::Check;
+
+// 组件数量大于BoundsGrain,覆盖多个并行块
+constexpr int32_t CompCount = 10000;
+
+bool Near(float a, float b)
+{
+    return std::abs(a - b) <= 1.0e-4f * (1.0f + std::max(std::abs(a), std::abs(b)));
+}
+
+bool Near(const glm::vec3 &a, const glm::vec3 &b)
+{
+    return Near(a.x, b.x) && Near(a.y, b.y) && Near(a.z, b.z);
+}
+
+bool Contains(const vgo::Aabb &outer, const vgo::Aabb &inner)
+{
+    auto tolerance = [](float value) { return 1.0e-4f * (1.0f + std::abs(value)); };
+    return inner.Min.x >= outer.Min.x - tolerance(outer.Min.x) && inner.Min.y >= outer.Min.y - tolerance(outer.Min.y) &&
+           inner.Min.z >= outer.Min.z - tolerance(outer.Min.z) && inner.Max.x <= outer.Max.x + tolerance(outer.Max.x) &&
+           inner.Max.y <= outer.Max.y + tolerance(outer.Max.y) && inner.Max.z <= outer.Max.z + tolerance(outer.Max.z);
+}
+
+vgo::Aabb CornerBounds(const glm::mat4 &trans, const glm::vec3 &min, const glm::vec3 &max)
+{
+    vgo::Aabb result;
+    for (int32_t i = 0; i < 8; i++)
+    {
+        glm::vec3 corner(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+        glm::vec3 p = trans * glm::vec4(corner, 1.0f);
+        result.Min = glm::min(result.Min, p);
+        result.Max = glm::max(result.Max, p);
+    }
+    return result;
+}
+
+// 依次使用旋转,非均匀缩放,镜像以及三者的组合
+glm::mat4 MakeMatrix(int32_t index, std::mt19937 &random)
+{
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+    glm::mat4 trans = glm::translate(vgo::Mat4Identity, glm::vec3(position(random), position(random), position(random)));
+    glm::vec3 axis = glm::normalize(glm::vec3(position(random), position(random), position(random)) + 0.01f);
+    switch (index % 4)
+    {
+    case 0:
+        return glm::rotate(trans, angle(random), axis);
+    case 1:
+        return glm::scale(trans, glm::vec3(scale(random), scale(random), scale(random)));
+    case 2:
+        return glm::scale(trans, glm::vec3(index & 4 ? -1.0f : 1.0f, index & 8 ? -1.0f : 1.0f, -1.0f));
+    default:
+        trans = glm::rotate(trans, angle(random), axis);
+        return glm::scale(trans, glm::vec3(-scale(random), scale(random), scale(random)));
+    }
+}
+} // namespace
+
+int main()
+{
+    vgo::SyntheticParams params;
+    params.CompCount = CompCount;
+    params.TrianglesPerPart = 32;
+    params.InstancingRatio = 0.9992f;
+    vgo::test::TestAssembly assembly(params);
+    const auto &asmGeometry = assembly.Geometry;
+
+    // part的包围盒比顶点略大且不对称,与转换工具生成的包围盒一样只保证包含顶点
+    for (auto &part : assembly.Parts)
+    {
+        part.Box[0] -= glm::vec3(0.25f);
+        part.Box[1] += glm::vec3(0.5f, 0.25f, 0.75f);
+    }
+    std::mt19937 random(11);
+    for (int32_t i = 0; i < CompCount; i++)
+    {
+        assembly.Components[i].CompMatrix = MakeMatrix(i, random);
+    }
+
+    vgo::BoundsCache boxCache;
+    boxCache.Update(asmGeometry, vgo::BoundsMode::Box);
+    vgo::BoundsCache vertexCache;
+    vertexCache.Update(asmGeometry, vgo::BoundsMode::Vertices);
+    Check(static_cast<int32_t>(boxCache.GetCompBounds().size()) == CompCount, "box bounds count", -1);
+    Check(static_cast<int32_t>(vertexCache.GetCompBounds().size()) == CompCount, "vertex bounds count", -1);
+    if (vgo::test::failures > 0)
+    {
+        return vgo::test::Finish("bounds");
+    }
+
+    vgo::Aabb total;
+    for (int32_t i = 0; i < CompCount; i++)
+    {
+        const auto &comp = asmGeometry.Components[i];
+        const auto &part = asmGeometry.Parts[comp.PartIndex];
+        auto expected = CornerBounds(comp.CompMatrix, part.Box[0], part.Box[1]);
+        total.Merge(expected);
+
+        vgo::Aabb box;
+        vgo::TransformBox(comp.CompMatrix, part.Box[0], part.Box[1], box);
+        Check(Near(box.Min, expected.Min) && Near(box.Max, expected.Max), "TransformBox matches 8 corners", i);
+        const auto &cached = boxCache.GetCompBounds()[i];
+        Check(Near(cached.Min, expected.Min) && Near(cached.Max, expected.Max), "Box bounds match 8 corners", i);
+
+        vgo::Aabb points;
+        for (int32_t k = part.FaceStartIndex; k < part.FaceStartIndex + part.FaceCount; k++)
+        {
+            glm::vec3 p = comp.CompMatrix * glm::vec4(glm::vec3(part.Vertices[part.Indices[k]]), 1.0f);
+            points.Min = glm::min(points.Min, p);
+            points.Max = glm::max(points.Max, p);
+        }
+        const auto &tight = vertexCache.GetCompBounds()[i];
+        Check(Near(tight.Min, points.Min) && Near(tight.Max, points.Max), "Vertices bounds match vertices", i);
+        Check(Contains(cached, tight), "Vertices bounds inside Box bounds", i);
+    }
+    Check(Near(boxCache.GetBounds().Min, total.Min) && Near(boxCache.GetBounds().Max, total.Max),
+          "total bounds match 8 corners", -1);
+    Check(Contains(boxCache.GetBounds(), vertexCache.GetBounds()), "total Vertices bounds inside Box bounds", -1);
+    return vgo::test::Finish("bounds");
+}
@@ -0,0 +1,143 @@
+#include "Bounds.h"
+#include "Meshlet.h"
+#include "Selection.h"
+#include "TestCommon.h"
+#include <algorithm>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <iostream>
+#include <vector>
+
+// RectSelector与逐个三角形暴力判断的结果对比: 窗选要求组件所有面的顶点都在矩形内,
+// 交叉选择要求至少一个三角形与矩形相交,分别在有无meshlet加速时检查
+// 用法: vgo_test_selection,全部通过返回0
+namespace
+{
+using vgo::test::Check;
+
+float Cross(const glm::vec2 &p, const glm::vec2 &q, const glm::vec2 &r)
+{
+    return (q.x - p.x) * (r.y - p.y) - (q.y - p.y) * (r.x - p.x);
+}
+
+bool SegmentsIntersect(const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &c, const glm::vec2 &d)
+{
+    return ((Cross(c, d, a) > 0.0f) != (Cross(c, d, b) > 0.0f)) &&
+           ((Cross(a, b, c) > 0.0f) != (Cross(a, b, d) > 0.0f));
+}
+
+bool InTriangle(const glm::vec2 &p, const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &c)
+{
+    float d0 = Cross(a, b, p);
+    float d1 = Cross(b, c, p);
+    float d2 = Cross(c, a, p);
+    bool negative = d0 < 0.0f || d1 < 0.0f || d2 < 0.0f;
+    bool positive = d0 > 0.0f || d1 > 0.0f || d2 > 0.0f;
+    return !(negative && positive);
+}
+
+bool InRect(const glm::vec2 &p, const vgo::SelectRect &rect)
+{
+    return p.x >= rect.Min.x && p.x <= rect.Max.x && p.y >= rect.Min.y && p.y <= rect.Max.y;
+}
+
+// 不做任何剔除,逐个三角形投影到NDC判断
+bool Reference(const vgo::AsmGeometry &asmGeometry, const vgo::CullCamera &camera, const vgo::SelectRect &rect,
+               vgo::SelectMode mode, int32_t compIndex)
+{
+    const auto &comp = asmGeometry.Components[compIndex];
+    const auto &part = asmGeometry.Parts[comp.PartIndex];
+    glm::mat4 toNdc = camera.Proj * camera.View * comp.CompMatrix;
+    glm::vec2 corners[4] = {rect.Min, {rect.Max.x, rect.Min.y}, rect.Max, {rect.Min.x, rect.Max.y}};
+    bool allInside = true;
+    bool crossing = false;
+    for (int32_t i = part.FaceStartIndex; i < part.FaceStartIndex + part.FaceCount; i += 3)
+    {
+        glm::vec2 triangle[3];
+        for (int32_t k = 0; k < 3; k++)
+        {
+            glm::vec4 clip = toNdc * glm::vec4(glm::vec3(part.Vertices[part.Indices[i + k]]), 1.0f);
+            triangle[k] = glm::vec2(clip.x, clip.y) + camera.Offset;
+            bool inside = InRect(triangle[k], rect);
+            allInside = allInside && inside;
+            crossing = crossing || inside;
+        }
+        for (int32_t c = 0; c < 4 && !crossing; c++)
+        {
+            crossing = InTriangle(corners[c], triangle[0], triangle[1], triangle[2]);
+        }
+        for (int32_t e = 0; e < 3 && !crossing; e++)
+        {
+            for (int32_t r = 0; r < 4 && !crossing; r++)
+            {
+                crossing = SegmentsIntersect(triangle[e], triangle[(e + 1) % 3], corners[r], corners[(r + 1) % 4]);
+            }
+        }
+    }
+    return mode == vgo::SelectMode::Inside ? allInside : crossing;
+}
+} // namespace
+
+int main()
+{
+    vgo::SyntheticParams params;
+    params.CompCount = 20000;
+    params.TrianglesPerPart = 64;
+    params.Distribution = vgo::SyntheticDistribution::Clustered;
+    vgo::test::TestAssembly assembly(params);
+    const auto &asmGeometry = assembly.Geometry;
+    auto compCount = asmGeometry.Components.size();
+
+    vgo::BoundsCache bounds;
+    bounds.Update(asmGeometry);
+    vgo::MeshletCache meshlets;
+    meshlets.Update(asmGeometry);
+    vgo::RectSelector selector;
+    selector.Update(bounds.GetCompBounds());
+
+    // 与GlRender相同的正交相机,旋转之后包围盒不再与屏幕对齐,并带有平移
+    glm::mat4 world;
+    asmGeometry.CreateAsmWorldRH(bounds.GetBounds().Min, bounds.GetBounds().Max, 1, 1, world);
+    glm::mat4 rotate = glm::rotate(vgo::Mat4Identity, 0.5f, glm::normalize(glm::vec3(1.0f, 0.3f, 0.0f)));
+    vgo::CullCamera camera{glm::lookAt(glm::vec3(0.0f, 0.0f, -20.0f), vgo::Vec3Zero, vgo::Vec3Unity) * rotate * world,
+                           glm::ortho(-1.3f, 1.3f, -1.0f, 1.0f, 0.1f, 100.0f), glm::vec2(0.05f, -0.02f)};
+
+    vgo::SelectRect rects[] = {vgo::ScreenToNdcRect(100, 100, 500, 400, 800, 600),
+                               vgo::ScreenToNdcRect(410, 310, 390, 290, 800, 600),
+                               vgo::ScreenToNdcRect(0, 0, 800, 600, 800, 600)};
+    for (const auto &rect : rects)
+    {
+        for (auto mode : {vgo::SelectMode::Inside, vgo::SelectMode::Crossing})
+        {
+            std::vector<char> expected(compCount, 0);
+            int32_t expectedCount = 0;
+            for (int32_t i = 0; i < static_cast<int32_t>(compCount); i++)
+            {
+                expected[i] = Reference(asmGeometry, camera, rect, mode, i);
+                expectedCount += expected[i];
+            }
+            const vgo::MeshletCache *caches[] = {nullptr, &meshlets};
+            for (auto cache : caches)
+            {
+                std::vector<int32_t> result;
+                selector.Select(asmGeometry, camera, rect, mode, result, cache);
+                Check(std::is_sorted(result.begin(), result.end()), "result sorted", -1);
+                Check(static_cast<int32_t>(result.size()) == expectedCount, "selected count", -1);
+                std::vector<char> selected(compCount, 0);
+                for (auto comp : result)
+                {
+                    selected[comp] = 1;
+                }
+                for (int32_t i = 0; i < static_cast<int32_t>(compCount); i++)
+                {
+                    Check(selected[i] == expected[i],
+                          mode == vgo::SelectMode::Inside ? "inside matches reference" : "crossing matches reference",
+                          i);
+                }
+            }
+            std::cout << (mode == vgo::SelectMode::Inside ? "inside " : "crossing ") << expectedCount << " / "
+                      << compCount << std::endl;
+        }
+    }
+    return vgo::test::Finish("selection");
+}
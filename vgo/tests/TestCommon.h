@@ -0,0 +1,61 @@
+#pragma once
+#include "SyntheticAssembly.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// 测试共用的检查函数和合成装配体,每个测试程序只包含一次
+namespace vgo::test
+{
+inline int32_t failures = 0;
+
+// 失败时只打印前20条,避免大量组件同时出错时刷屏
+inline void Check(bool condition, const char *what, int32_t index)
+{
+    if (!condition)
+    {
+        if (failures < 20)
+        {
+            std::cout << "FAILED: " << what << " (component " << index << ")" << std::endl;
+        }
+        failures++;
+    }
+}
+
+// 打印结果并返回main的返回值,全部通过返回0
+inline int Finish(const char *name)
+{
+    if (failures > 0)
+    {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all " << name << " checks passed" << std::endl;
+    return 0;
+}
+
+// SyntheticAssembly的part和组件表的可修改副本,测试可以替换组件矩阵和part包围盒,
+// 顶点和索引数组仍然属于assembly
+class TestAssembly
+{
+  public:
+    explicit TestAssembly(const SyntheticParams &params) : assembly(params)
+    {
+        const auto &source = assembly.GetGeometry();
+        Parts.assign(source.Parts.begin(), source.Parts.end());
+        Components.assign(source.Components.begin(), source.Components.end());
+        Geometry.Parts = UnSafeArray<PartGeometry>(Parts.data(), static_cast<int32_t>(Parts.size()));
+        Geometry.Components = UnSafeArray<CompGeometry>(Components.data(), static_cast<int32_t>(Components.size()));
+    }
+
+    TestAssembly(const TestAssembly &) = delete;
+    TestAssembly &operator=(const TestAssembly &) = delete;
+
+    std::vector<PartGeometry> Parts;
+    std::vector<CompGeometry> Components;
+    AsmGeometry Geometry;
+
+  private:
+    SyntheticAssembly assembly;
+};
+} // namespace vgo::test
@@ -0,0 +1,28 @@
+#include "ModelFile.h"
+#include <cstring>
+#include <iostream>
+
+// 将旧版.mem转换成v2模型容器
+// 用法: vgo_convert <input.mem> <output.vgo> [--compress]
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "usage: vgo_convert <input.mem> <output.vgo> [--compress]" << std::endl;
+        return 1;
+    }
+    bool compress = argc > 3 && std::strcmp(argv[3], "--compress") == 0;
+    try
+    {
+        vgo::MemModel mem(argv[1]);
+        vgo::WriteModelFile(mem.GetGeometry(), argv[2], compress);
+        std::cout << "parts: " << mem.GetGeometry().Parts.size()
+                  << ", components: " << mem.GetGeometry().Components.size() << std::endl;
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}